@@ -429,15 +429,35 @@ evdev_event_from_input_event(const struct input_event *e, usec_t *time)
  *
  * The struct should be considered opaque, use the helpers
  * to access the various fields.
+ *
+ * A frame may be shared copy-on-write with one other owner, see
+ * evdev_frame_share().
  */
 struct evdev_frame {
 	int refcount;
 	size_t max_size;
 	size_t count;
 	usec_t time;
+	struct evdev_frame **shared_with; /* holds a ref, see evdev_frame_share() */
+	struct evdev_frame_pool *pool;    /* returned here on the last unref */
 	struct evdev_event events[];
 };
 
+/* The size of pooled frames, larger frames are never pooled */
+#define EVDEV_FRAME_POOL_FRAME_SIZE 64
+/* Max number of unused frames we keep around per pool */
+#define EVDEV_FRAME_POOL_SIZE 16
+
+/**
+ * A cache of unused frames so that frames created and destroyed for
+ * every event frame don't hit the heap, see evdev_frame_new_pooled().
+ * The pool must outlive all frames allocated from it.
+ */
+struct evdev_frame_pool {
+	struct evdev_frame *frames[EVDEV_FRAME_POOL_SIZE];
+	size_t count;
+};
+
 static inline struct evdev_frame *
 evdev_frame_ref(struct evdev_frame *frame)
 {
@@ -452,6 +472,13 @@ evdev_frame_unref(struct evdev_frame *frame)
 	if (frame) {
 		assert(frame->refcount > 0);
 		if (--frame->refcount == 0) {
+			struct evdev_frame_pool *pool = frame->pool;
+
+			if (pool && pool->count < ARRAY_LENGTH(pool->frames)) {
+				pool->frames[pool->count++] = frame;
+				return NULL;
+			}
+
 			frame->max_size = 0;
 			frame->count = 0;
 			free(frame);
@@ -462,6 +489,152 @@ evdev_frame_unref(struct evdev_frame *frame)
 
 DEFINE_UNREF_CLEANUP_FUNC(evdev_frame);
 
+static inline struct evdev_frame *
+evdev_frame_new(size_t max_size)
+{
+	struct evdev_frame *frame =
+		zalloc(max_size * sizeof(*frame->events) + sizeof(*frame));
+
+	frame->refcount = 1;
+	frame->max_size = max_size;
+	frame->count = 1; /* SYN_REPORT is always there */
+
+	return frame;
+}
+
+/**
+ * Like evdev_frame_new() but re-uses an unused frame from the pool if
+ * possible. The frame returns to the pool once its last reference is
+ * dropped. Frames larger than EVDEV_FRAME_POOL_FRAME_SIZE are
+ * allocated normally.
+ */
+static inline struct evdev_frame *
+evdev_frame_new_pooled(struct evdev_frame_pool *pool, size_t max_size)
+{
+	struct evdev_frame *frame;
+
+	if (max_size > EVDEV_FRAME_POOL_FRAME_SIZE)
+		return evdev_frame_new(max_size);
+
+	if (pool->count == 0) {
+		frame = evdev_frame_new(EVDEV_FRAME_POOL_FRAME_SIZE);
+		frame->pool = pool;
+		return frame;
+	}
+
+	frame = pool->frames[--pool->count];
+	memset(frame->events, 0, frame->max_size * sizeof(*frame->events));
+	frame->refcount = 1;
+	frame->count = 1;
+	frame->time = usec_from_uint64_t(0);
+	frame->shared_with = NULL;
+
+	return frame;
+}
+
+static inline void
+evdev_frame_pool_destroy(struct evdev_frame_pool *pool)
+{
+	for (size_t i = 0; i < pool->count; i++)
+		free(pool->frames[i]);
+	pool->count = 0;
+}
+
+static inline struct evdev_frame *
+evdev_frame_copy(const struct evdev_frame *frame)
+{
+	struct evdev_frame *copy = frame->pool
+		? evdev_frame_new_pooled(frame->pool, frame->count)
+		: evdev_frame_new(frame->count);
+
+	memcpy(copy->events, frame->events, frame->count * sizeof(*frame->events));
+	copy->count = frame->count;
+	copy->time = frame->time;
+
+	return copy;
+}
+
+/**
+ * Share this frame with the given slot instead of copying it: the slot
+ * takes a reference to the frame. If the frame is modified through any
+ * of the evdev_frame helpers while it is still shared, the slot is
+ * given a private copy of the unmodified frame first. Writes through
+ * the pointer returned by evdev_frame_get_events() are not tracked.
+ *
+ * A frame can only be shared with one slot at a time, if it is already
+ * shared the slot receives a copy immediately.
+ */
+static inline void
+evdev_frame_share(struct evdev_frame *frame, struct evdev_frame **slot)
+{
+	if (frame->shared_with) {
+		*slot = evdev_frame_copy(frame);
+		return;
+	}
+
+	frame->shared_with = slot;
+	*slot = evdev_frame_ref(frame);
+}
+
+/**
+ * Detach the frame from the slot it is shared with (if any) by giving
+ * that slot a private copy. Called before every modification of the
+ * frame.
+ */
+static inline void
+evdev_frame_unshare(struct evdev_frame *frame)
+{
+	struct evdev_frame **slot = frame->shared_with;
+
+	if (!slot)
+		return;
+
+	frame->shared_with = NULL;
+
+	/* Nobody but the slot has a ref, no need to copy */
+	if (frame->refcount == 1)
+		return;
+
+	*slot = evdev_frame_copy(frame);
+	evdev_frame_unref(frame);
+}
+
+/**
+ * Take exclusive ownership of the frame in the slot. If the frame is
+ * shared with this slot and anyone else still holds a reference, the
+ * slot is replaced with a private copy. Returns the (possibly new)
+ * frame in the slot.
+ */
+static inline struct evdev_frame *
+evdev_frame_take_shared(struct evdev_frame **slot)
+{
+	struct evdev_frame *frame = *slot;
+
+	if (frame->shared_with != slot)
+		return frame;
+
+	frame->shared_with = NULL;
+	if (frame->refcount > 1) {
+		*slot = evdev_frame_copy(frame);
+		evdev_frame_unref(frame);
+	}
+
+	return *slot;
+}
+
+/**
+ * Release the slot's reference to its frame, ending any sharing.
+ */
+static inline void
+evdev_frame_release_shared(struct evdev_frame **slot)
+{
+	struct evdev_frame *frame = *slot;
+
+	if (frame && frame->shared_with == slot)
+		frame->shared_with = NULL;
+	*slot = evdev_frame_unref(frame);
+}
+
 static inline bool
 evdev_frame_is_empty(const struct evdev_frame *frame)
 {
@@ -489,6 +662,7 @@ evdev_frame_get_events(struct evdev_frame *frame, size_t *nevents)
 static inline void
 evdev_frame_set_time(struct evdev_frame *frame, usec_t time)
 {
+	evdev_frame_unshare(frame);
 	frame->time = time;
 }
 
@@ -501,25 +675,13 @@ evdev_frame_get_time(const struct evdev_frame *frame)
 static inline int
 evdev_frame_reset(struct evdev_frame *frame)
 {
+	evdev_frame_unshare(frame);
 	memset(frame->events, 0, frame->max_size * sizeof(*frame->events));
 	frame->count = 1; /* SYN_REPORT is always there */
 
 	return 0;
 }
 
-static inline struct evdev_frame *
-evdev_frame_new(size_t max_size)
-{
-	struct evdev_frame *frame =
-		zalloc(max_size * sizeof(*frame->events) + sizeof(*frame));
-
-	frame->refcount = 1;
-	frame->max_size = max_size;
-	frame->count = 1; /* SYN_REPORT is always there */
-
-	return frame;
-}
-
 /**
  * Append events to the event frame. nevents must be larger than 0
  * and specifies the number of elements in events. If any events in
@@ -552,6 +714,8 @@ evdev_frame_append(struct evdev_frame *frame,
 	assert(nevents > 0);
 	int syn_report_value = 0;
 
+	evdev_frame_unshare(frame);
+
 	for (size_t i = 0; i < nevents; i++) {
 		if (evdev_usage_eq(events[i].usage, EVDEV_SYN_REPORT)) {
 			nevents = i;
@@ -581,6 +745,8 @@ evdev_frame_append(struct evdev_frame *frame,
 static inline int
 evdev_frame_append_one(struct evdev_frame *frame, evdev_usage_t usage, int32_t value)
 {
+	evdev_frame_unshare(frame);
+
 	if (evdev_usage_eq(usage, EVDEV_SYN_REPORT)) {
 		frame->events[frame->count - 1] = (struct evdev_event){
 			.usage = evdev_usage_from_uint32_t(EVDEV_SYN_REPORT),
@@ -645,7 +811,9 @@ evdev_frame_clone(struct evdev_frame *frame)
 {
 	size_t nevents;
 	struct evdev_event *events = evdev_frame_get_events(frame, &nevents);
-	struct evdev_frame *clone = evdev_frame_new(nevents);
+	struct evdev_frame *clone = frame->pool
+		? evdev_frame_new_pooled(frame->pool, nevents)
+		: evdev_frame_new(nevents);
 
 	evdev_frame_append(clone, events, nevents);
 	evdev_frame_set_time(clone, evdev_frame_get_time(frame));
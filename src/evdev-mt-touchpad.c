@@ -2555,6 +2555,76 @@ tp_pair_tablet_mode_switch(struct evdev_device *touchpad,
 	}
 }
 
+static bool
+tp_requires_rotation(struct tp_dispatch *tp, struct evdev_device *device)
+{
+	bool rotate = false;
+#ifdef HAVE_LIBWACOM
+	struct libinput *li = tp_libinput_context(tp);
+	WacomDeviceDatabase *db = NULL;
+	WacomDevice **devices = NULL, **d;
+	WacomDevice *dev;
+	uint32_t vid = evdev_device_get_id_vendor(device),
+		 pid = evdev_device_get_id_product(device);
+
+	if ((device->tags & EVDEV_TAG_TABLET_TOUCHPAD) == 0)
+		goto out;
+
+	db = libinput_libwacom_ref(li);
+	if (!db)
+		goto out;
+
+	/* Check if we have a device with the same vid/pid. If not,
+	   we need to loop through all devices and check their paired
+	   device. */
+	dev = libwacom_new_from_usbid(db, vid, pid, NULL);
+	if (dev) {
+		rotate = libwacom_is_reversible(dev);
+		libwacom_destroy(dev);
+		goto out;
+	}
+
+	devices = libwacom_list_devices_from_database(db, NULL);
+	if (!devices)
+		goto out;
+	d = devices;
+	while (*d) {
+		const WacomMatch *paired;
+
+		paired = libwacom_get_paired_device(*d);
+		if (paired && libwacom_match_get_vendor_id(paired) == vid &&
+		    libwacom_match_get_product_id(paired) == pid) {
+			rotate = libwacom_is_reversible(*d);
+			break;
+		}
+		d++;
+	}
+
+	free(devices);
+
+out:
+	/* We don't need to keep it around for the touchpad, we're done with
+	 * it until the device dies. */
+	if (db)
+		libinput_libwacom_unref(li);
+#endif
+
+	return rotate;
+}
+
+/* tp_requires_rotation() needs the libwacom database, so we only
+ * look it up once a tablet pairs or the left-handed setting changes */
+static bool
+tp_must_rotate(struct tp_dispatch *tp)
+{
+	if (!tp->left_handed.must_rotate_checked) {
+		tp->left_handed.must_rotate = tp_requires_rotation(tp, tp->device);
+		tp->left_handed.must_rotate_checked = true;
+	}
+
+	return tp->left_handed.must_rotate;
+}
+
 static void
 tp_change_rotation(struct evdev_device *device, enum notify notify)
 {
@@ -2562,7 +2632,7 @@ tp_change_rotation(struct evdev_device *device, enum notify notify)
 	struct evdev_device *tablet_device = tp->left_handed.tablet_device;
 	bool tablet_is_left, touchpad_is_left;
 
-	if (!tp->left_handed.must_rotate)
+	if (!tp_must_rotate(tp))
 		return;
 
 	touchpad_is_left = device->left_handed.enabled;
@@ -2588,7 +2658,7 @@ tp_pair_tablet(struct evdev_device *touchpad, struct evdev_device *tablet)
 {
 	struct tp_dispatch *tp = (struct tp_dispatch *)touchpad->dispatch;
 
-	if (!tp->left_handed.must_rotate)
+	if (!tp_must_rotate(tp))
 		return;
 
 	if ((tablet->seat_caps & EVDEV_DEVICE_TABLET) == 0)
@@ -3996,70 +4066,11 @@ tp_change_to_left_handed(struct evdev_device *device)
 	tp_change_rotation(device, DO_NOTIFY);
 }
 
-static bool
-tp_requires_rotation(struct tp_dispatch *tp, struct evdev_device *device)
-{
-	bool rotate = false;
-#ifdef HAVE_LIBWACOM
-	struct libinput *li = tp_libinput_context(tp);
-	WacomDeviceDatabase *db = NULL;
-	WacomDevice **devices = NULL, **d;
-	WacomDevice *dev;
-	uint32_t vid = evdev_device_get_id_vendor(device),
-		 pid = evdev_device_get_id_product(device);
-
-	if ((device->tags & EVDEV_TAG_TABLET_TOUCHPAD) == 0)
-		goto out;
-
-	db = libinput_libwacom_ref(li);
-	if (!db)
-		goto out;
-
-	/* Check if we have a device with the same vid/pid. If not,
-	   we need to loop through all devices and check their paired
-	   device. */
-	dev = libwacom_new_from_usbid(db, vid, pid, NULL);
-	if (dev) {
-		rotate = libwacom_is_reversible(dev);
-		libwacom_destroy(dev);
-		goto out;
-	}
-
-	devices = libwacom_list_devices_from_database(db, NULL);
-	if (!devices)
-		goto out;
-	d = devices;
-	while (*d) {
-		const WacomMatch *paired;
-
-		paired = libwacom_get_paired_device(*d);
-		if (paired && libwacom_match_get_vendor_id(paired) == vid &&
-		    libwacom_match_get_product_id(paired) == pid) {
-			rotate = libwacom_is_reversible(*d);
-			break;
-		}
-		d++;
-	}
-
-	free(devices);
-
-out:
-	/* We don't need to keep it around for the touchpad, we're done with
-	 * it until the device dies. */
-	if (db)
-		libinput_libwacom_unref(li);
-#endif
-
-	return rotate;
-}
-
 static void
 tp_init_left_handed(struct tp_dispatch *tp, struct evdev_device *device)
 {
 	bool want_left_handed = true;
 
-	tp->left_handed.must_rotate = tp_requires_rotation(tp, device);
-
 	if (device->model_flags & EVDEV_MODEL_APPLE_TOUCHPAD_ONEBUTTON)
 		want_left_handed = false;
 	if (want_left_handed)
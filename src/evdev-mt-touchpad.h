@@ -587,6 +587,7 @@ struct tp_dispatch {
 		bool want_rotate;
 
 		bool must_rotate; /* true if we should rotate when applicable */
+		bool must_rotate_checked; /* see tp_must_rotate() */
 		struct evdev_device *tablet_device;
 		bool tablet_left_handed_state;
 	} left_handed;
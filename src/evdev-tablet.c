@@ -1435,6 +1435,9 @@ tablet_new_tool(struct tablet_dispatch *tablet,
 			eraser_button_get_default_button,
 	};
 
+	list_init(&tool->link);
+	list_init(&tool->index_link);
+
 	tool_init_pressure_thresholds(tablet, tool, &tool->pressure.threshold);
 	tool_set_bits(tablet, tool, s);
 	tool_init_eraser_button(tablet, tool, s);
@@ -1442,65 +1445,187 @@ tablet_new_tool(struct tablet_dispatch *tablet,
 	return tool;
 }
 
+/* Minimum number of tools in the index before we start evicting unused
+ * ones */
+#define TOOL_INDEX_EVICT_THRESHOLD 64
+#define TOOL_INDEX_MIN_BUCKETS 16
+
+static inline size_t
+tool_index_bucket(struct libinput *libinput,
+		  enum libinput_tablet_tool_type type,
+		  uint32_t serial)
+{
+	uint32_t h = (serial ^ ((uint32_t)type << 24)) * 2654435761U;
+
+	h ^= h >> 16;
+
+	return h & (libinput->tool_index.nbuckets - 1);
+}
+
 static struct libinput_tablet_tool *
-tablet_get_tool(struct tablet_dispatch *tablet,
+tool_index_find(struct libinput *libinput,
 		enum libinput_tablet_tool_type type,
-		uint32_t tool_id,
 		uint32_t serial)
 {
-	struct evdev_device *device = tablet->device;
-	struct libinput *libinput = tablet_libinput_context(tablet);
-	struct libinput_tablet_tool *tool = NULL, *t;
-	struct list *tool_list;
+	struct libinput_tablet_tool *t;
+	struct list *bucket;
 
-	if (serial) {
-		tool_list = &libinput->tool_list;
-		/* Check if we already have the tool in our list of tools */
-		list_for_each(t, tool_list, link) {
-			if (type == t->type && serial == t->serial) {
-				tool = t;
-				break;
-			}
+	if (libinput->tool_index.count == 0)
+		return NULL;
+
+	bucket = &libinput->tool_index.buckets[tool_index_bucket(libinput, type, serial)];
+	list_for_each(t, bucket, index_link) {
+		if (type == t->type && serial == t->serial)
+			return t;
+	}
+
+	return NULL;
+}
+
+static void
+tool_index_resize(struct libinput *libinput, size_t nbuckets)
+{
+	struct list *old = libinput->tool_index.buckets;
+	size_t nold = libinput->tool_index.nbuckets;
+	struct libinput_tablet_tool *t;
+
+	libinput->tool_index.buckets = zalloc(nbuckets * sizeof(*old));
+	libinput->tool_index.nbuckets = nbuckets;
+	for (size_t i = 0; i < nbuckets; i++)
+		list_init(&libinput->tool_index.buckets[i]);
+
+	for (size_t i = 0; i < nold; i++) {
+		list_for_each_safe(t, &old[i], index_link) {
+			size_t b = tool_index_bucket(libinput, t->type, t->serial);
+
+			list_remove(&t->index_link);
+			list_insert(&libinput->tool_index.buckets[b], &t->index_link);
 		}
 	}
 
+	free(old);
+}
+
+static void
+tool_index_insert(struct libinput *libinput, struct libinput_tablet_tool *tool)
+{
+	size_t nbuckets = libinput->tool_index.nbuckets;
+
+	if (libinput->tool_index.count >= nbuckets * 2)
+		tool_index_resize(libinput, max(nbuckets * 2, TOOL_INDEX_MIN_BUCKETS));
+
+	list_insert(&libinput->tool_index.buckets[tool_index_bucket(libinput,
+								    tool->type,
+								    tool->serial)],
+		    &tool->index_link);
+	libinput->tool_index.count++;
+}
+
+static bool
+tool_is_evictable(struct libinput_tablet_tool *tool)
+{
+	/* The only ref is the one from the tool list, so no tablet has
+	 * this tool in proximity and the caller doesn't hold on to it */
+	if (tool->refcount > 1)
+		return false;
+
+	/* Keep anything that would lose caller-visible state */
+	return !tool->user_data && !tool->pressure.has_configured_range &&
+	       tool->eraser_button.want_mode == LIBINPUT_CONFIG_ERASER_BUTTON_DEFAULT &&
+	       tool->eraser_button.want_button ==
+		       eraser_button_get_default_button(tool);
+}
+
+static void
+tool_index_evict_idle(struct libinput *libinput)
+{
+	struct libinput_tablet_tool *t;
+
+	if (libinput->tool_index.count <
+	    max(libinput->tool_index.evict_threshold, TOOL_INDEX_EVICT_THRESHOLD))
+		return;
+
+	for (size_t i = 0; i < libinput->tool_index.nbuckets; i++) {
+		list_for_each_safe(t, &libinput->tool_index.buckets[i], index_link) {
+			if (!tool_is_evictable(t))
+				continue;
+
+			list_remove(&t->index_link);
+			libinput->tool_index.count--;
+			libinput_tablet_tool_unref(t);
+		}
+	}
+
+	/* If most tools are still in use, don't re-scan on every new tool */
+	libinput->tool_index.evict_threshold = libinput->tool_index.count * 2;
+}
+
+static struct libinput_tablet_tool *
+tablet_find_tool(struct tablet_dispatch *tablet,
+		 enum libinput_tablet_tool_type type,
+		 uint32_t tool_id,
+		 uint32_t serial)
+{
+	struct libinput *libinput = tablet_libinput_context(tablet);
+	struct libinput_tablet_tool *tool = NULL;
+
+	if (serial)
+		tool = tool_index_find(libinput, type, serial);
+
 	/* If we get a tool with a delayed serial number, we already created
 	 * a 0-serial number tool for it earlier. Re-use that, even though
 	 * it means we can't distinguish this tool from others.
 	 * https://bugs.freedesktop.org/show_bug.cgi?id=97526
+	 *
+	 * We can't guarantee that tools without serial numbers are
+	 * unique, so we keep them local to the tablet that they come
+	 * into proximity of instead of storing them in the global tool
+	 * list.
 	 */
-	if (!tool) {
-		tool_list = &tablet->tool_list;
-		/* We can't guarantee that tools without serial numbers are
-		 * unique, so we keep them local to the tablet that they come
-		 * into proximity of instead of storing them in the global tool
-		 * list
-		 * Same as above, but don't bother checking the serial number
-		 */
-		list_for_each(t, tool_list, link) {
-			if (type == t->type) {
-				tool = t;
-				break;
-			}
-		}
+	if (!tool)
+		tool = tablet->tools_without_serial[type];
+
+	if (tool)
+		return tool;
 
-		/* Didn't find the tool but we have a serial. Switch
-		 * tool_list back so we create in the correct list */
-		if (!tool && serial)
-			tool_list = &libinput->tool_list;
+	tool = tablet_new_tool(tablet, type, tool_id, serial);
+	if (serial) {
+		tool_index_evict_idle(libinput);
+		list_insert(&libinput->tool_list, &tool->link);
+		tool_index_insert(libinput, tool);
+	} else {
+		tablet->tools_without_serial[type] = tool;
 	}
 
-	/* If we didn't already have the new_tool in our list of tools,
-	 * add it */
-	if (!tool) {
-		tool = tablet_new_tool(tablet, type, tool_id, serial);
-		list_insert(tool_list, &tool->link);
+	return tool;
+}
+
+static struct libinput_tablet_tool *
+tablet_get_tool(struct tablet_dispatch *tablet,
+		enum libinput_tablet_tool_type type,
+		uint32_t tool_id,
+		uint32_t serial)
+{
+	struct evdev_device *device = tablet->device;
+	struct libinput_tablet_tool *tool = tablet->last_tool;
+
+	assert(type > 0 && (size_t)type < ARRAY_LENGTH(tablet->tools_without_serial));
+
+	/* Most frames are from the same tool as the previous one */
+	if (!tool || tool->type != type || tool->serial != serial) {
+		tool = tablet_find_tool(tablet, type, tool_id, serial);
+		libinput_tablet_tool_ref(tool);
+		if (tablet->last_tool)
+			libinput_tablet_tool_unref(tablet->last_tool);
+		tablet->last_tool = tool;
 	}
 
-	struct libinput_device *last = tool->last_device;
-	tool->last_device = libinput_device_ref(&device->base);
-	if (last)
-		libinput_device_unref(last);
+	if (tool->last_device != &device->base) {
+		struct libinput_device *last = tool->last_device;
+		tool->last_device = libinput_device_ref(&device->base);
+		if (last)
+			libinput_device_unref(last);
+	}
 
 	tool->last_tablet_id = tablet->tablet_id;
 
@@ -2402,8 +2527,14 @@ tablet_remove(struct evdev_dispatch *dispatch)
 	struct libinput *libinput = tablet_libinput_context(tablet);
 	struct libinput_tablet_tool *tool;
 
-	list_for_each_safe(tool, &tablet->tool_list, link) {
-		if (tool->last_device == device) {
+	if (tablet->last_tool) {
+		libinput_tablet_tool_unref(tablet->last_tool);
+		tablet->last_tool = NULL;
+	}
+
+	ARRAY_FOR_EACH(tablet->tools_without_serial, t) {
+		tool = *t;
+		if (tool && tool->last_device == device) {
 			libinput_device_unref(tool->last_device);
 			tool->last_device = NULL;
 		}
@@ -2421,13 +2552,14 @@ static void
 tablet_destroy(struct evdev_dispatch *dispatch)
 {
 	struct tablet_dispatch *tablet = tablet_dispatch(dispatch);
-	struct libinput_tablet_tool *tool;
 	struct libinput *li = tablet_libinput_context(tablet);
 
-	list_for_each_safe(tool, &tablet->tool_list, link) {
-		list_remove(&tool->link);
-		list_init(&tool->link); /* unref may list_remove() too */
-		libinput_tablet_tool_unref(tool);
+	if (tablet->last_tool)
+		libinput_tablet_tool_unref(tablet->last_tool);
+
+	ARRAY_FOR_EACH(tablet->tools_without_serial, t) {
+		if (*t)
+			libinput_tablet_tool_unref(*t);
 	}
 
 	libinput_libwacom_unref(li);
@@ -2956,7 +3088,6 @@ tablet_init(struct tablet_dispatch *tablet, struct evdev_device *device)
 	tablet->device = device;
 	tablet->status = TABLET_NONE;
 	tablet->current_tool.type = LIBINPUT_TOOL_NONE;
-	list_init(&tablet->tool_list);
 
 	if (tablet_reject_device(device))
 		goto out;
@@ -78,8 +78,13 @@ struct tablet_dispatch {
 	int current_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
 	int prev_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
 
-	/* Only used for tablets that don't report serial numbers */
-	struct list tool_list;
+	/* Only used for tablets that don't report serial numbers, indexed
+	 * by tool type */
+	struct libinput_tablet_tool *tools_without_serial[LIBINPUT_TABLET_TOOL_TYPE_LENS + 1];
+
+	/* The tool of the last frame, we hold a ref so it can't be evicted
+	 * from the tool index while in use */
+	struct libinput_tablet_tool *last_tool;
 
 	struct button_state button_state;
 	struct button_state prev_button_state;
@@ -30,9 +30,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -44,9 +47,11 @@
 #include "filter.h"
 #include "libinput-plugin.h"
 #include "libinput-private.h"
+#include "libinput-uring.h"
 #include "libinput.h"
 #include "linux/input.h"
 #include "quirks.h"
+#include "reader-thread.h"
 
 #ifdef HAVE_LIBWACOM
 #include <libwacom/libwacom.h>
@@ -1014,6 +1019,39 @@ evdev_device_dispatch_frame(struct libinput *libinput,
 						  frame);
 }
 
+/**
+ * Dispatch a frame read from the device and record its latency
+ * histograms, see libinput_device_get_latency_stats().
+ */
+static inline void
+evdev_device_dispatch_frame_timed(struct libinput *libinput,
+				  struct evdev_device *device,
+				  struct evdev_frame *frame,
+				  const struct input_event *syn_report)
+{
+	struct libinput_latency_stats *latency = &device->base.latency;
+	usec_t frame_time, start;
+
+	if (!libinput->latency_stats) {
+		evdev_device_dispatch_frame(libinput, device, frame);
+		return;
+	}
+
+	frame_time = input_event_time(syn_report);
+	start = libinput_now(libinput);
+
+	/* A frame from the future means a different clock, e.g. a
+	 * recording replayed by the test suite */
+	if (usec_cmp(frame_time, start) <= 0)
+		latency_histogram_add(&latency->dispatch,
+				      usec_delta(start, frame_time));
+
+	evdev_device_dispatch_frame(libinput, device, frame);
+
+	latency_histogram_add(&latency->processing,
+			      usec_delta(libinput_now(libinput), start));
+}
+
 static inline void
 libinput_device_dispatch_frame(struct libinput_device *device,
 			       struct evdev_frame *frame)
@@ -1073,76 +1111,307 @@ evdev_note_time_delay(struct evdev_device *device, const struct input_event *ev)
 	}
 }
 
+/* Number of input events read() at once */
+#define EVDEV_READ_BATCH_SIZE 128
+
+/**
+ * Update libevdev's view of the device for an event we read from the fd
+ * ourselves, mirroring what libevdev_next_event() would have done.
+ *
+ * Returns false if libevdev would have filtered the event.
+ */
+static inline bool
+evdev_update_libevdev_state(struct libevdev *evdev, const struct input_event *ev)
+{
+	switch (ev->type) {
+	case EV_SYN:
+		return true;
+	case EV_ABS:
+	case EV_KEY:
+	case EV_LED:
+	case EV_SW:
+		return libevdev_set_event_value(evdev, ev->type, ev->code, ev->value) ==
+		       0;
+	default:
+		return libevdev_has_event_code(evdev, ev->type, ev->code);
+	}
+}
+
+static int
+evdev_device_handle_syn_dropped(struct evdev_device *device,
+				struct evdev_frame *frame,
+				const struct input_event *syn_dropped)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+	struct input_event ev = *syn_dropped;
+	int rc;
+
+	libinput->stats.syn_dropped++;
+	evdev_log_info_ratelimit(device,
+				 &device->syn_drop_limit,
+				 "SYN_DROPPED event - some input events have been lost.\n");
+
+	/* send one more sync event so we handle all
+	   currently pending events before we sync up
+	   to the current state */
+	ev.code = SYN_REPORT;
+
+	if (evdev_frame_append_input_event(frame, &ev) == -ENOMEM) {
+		evdev_log_bug_libinput(device,
+				       "event frame overflow, discarding events.\n");
+	}
+	evdev_device_dispatch_frame(libinput, device, frame);
+	evdev_frame_reset(frame);
+
+	/* Whatever io_uring read after the SYN_DROPPED is as stale as
+	 * what's left in the fd. Stop the read too, libevdev reads the
+	 * fd directly while syncing and must see all of it. */
+	if (device->uring_source)
+		libinput_uring_source_pause(device->uring_source);
+
+	/* libevdev didn't see the SYN_DROPPED, so tell it to sync. It
+	 * discards anything left in the fd and gives us the state delta */
+	rc = libevdev_next_event(device->evdev, LIBEVDEV_READ_FLAG_FORCE_SYNC, &ev);
+	if (rc == LIBEVDEV_READ_STATUS_SYNC)
+		rc = evdev_sync_device(libinput, device);
+
+	if (device->uring_source)
+		libinput_uring_source_resume(device->uring_source);
+
+	/* The reader thread stopped reading after the SYN_DROPPED */
+	if (device->reader_device)
+		reader_device_resume(device->reader_device);
+
+	return rc;
+}
+
+/**
+ * Read up to max_events events from the device, either directly from
+ * the fd or from what the reader thread has read for us.
+ *
+ * Returns the number of events read or a negative errno. A return
+ * value of less than max_events means no more events are available.
+ */
+static inline int
+evdev_device_read_events(struct evdev_device *device,
+			 struct input_event *events,
+			 size_t max_events)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+	ssize_t len;
+	int nevents;
+
+	if (device->reader_device) {
+		nevents = reader_device_read(device->reader_device,
+					     events,
+					     max_events);
+		return nevents == 0 ? -EAGAIN : nevents;
+	}
+
+	if (device->uring_source) {
+		/* The kernel has already read the events for us, this
+		 * is just a copy out of the shared buffers */
+		len = libinput_uring_source_read(device->uring_source,
+						 events,
+						 max_events * sizeof(*events));
+		if (len < 0)
+			return -errno;
+
+		nevents = len / sizeof(*events);
+		libinput->stats.read_events += nevents;
+
+		return nevents;
+	}
+
+	len = read(device->fd, events, max_events * sizeof(*events));
+	if (len < 0)
+		return -errno;
+
+	nevents = len / sizeof(*events);
+	if (nevents == 0)
+		return -EAGAIN;
+
+	libinput->stats.read_syscalls++;
+	libinput->stats.read_events += nevents;
+
+	return nevents;
+}
+
+static void
+evdev_device_remove_source(struct evdev_device *device)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+
+	if (device->reader_device) {
+		reader_thread_remove_device(libinput->reader,
+					    device->reader_device);
+		device->reader_device = NULL;
+	}
+
+	if (device->uring_source) {
+		libinput_uring_remove_source(device->uring_source);
+		device->uring_source = NULL;
+	}
+
+	if (device->source) {
+		libinput_remove_source(libinput, device->source);
+		device->source = NULL;
+	}
+}
+
 static void
 evdev_device_dispatch(void *data)
 {
 	struct evdev_device *device = data;
 	struct libinput *libinput = evdev_libinput_context(device);
-	struct input_event ev;
+	struct input_event events[EVDEV_READ_BATCH_SIZE];
+	struct evdev_frame *frame = device->read_frame;
+	size_t budget = libinput->dispatch_budget;
+	size_t remaining = budget ? budget : SIZE_MAX;
 	int rc;
 	bool once = false;
-	_unref_(evdev_frame) *frame = evdev_frame_new(64);
 
 	/* If the compositor is repainting, this function is called only once
 	 * per frame and we have to process all the events available on the
-	 * fd, otherwise there will be input lag. */
+	 * fd, otherwise there will be input lag.
+	 *
+	 * We read() the events in batches and split them into frames
+	 * directly rather than going through libevdev_next_event() for
+	 * each event. libevdev is kept up-to-date via
+	 * evdev_update_libevdev_state() and only takes over to re-sync
+	 * after a SYN_DROPPED.
+	 *
+	 * With a dispatch budget we stop once the budget is used up,
+	 * the fd stays readable and we continue with the next dispatch.
+	 */
 	do {
-		rc = libevdev_next_event(device->evdev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
-		if (rc == LIBEVDEV_READ_STATUS_SYNC) {
-			evdev_log_info_ratelimit(
-				device,
-				&device->syn_drop_limit,
-				"SYN_DROPPED event - some input events have been lost.\n");
+		size_t want = min(ARRAY_LENGTH(events), remaining);
+		rc = evdev_device_read_events(device, events, want);
+		if (rc < 0)
+			break;
 
-			/* send one more sync event so we handle all
-			   currently pending events before we sync up
-			   to the current state */
-			ev.code = SYN_REPORT;
+		size_t nevents = rc;
 
-			if (evdev_frame_append_input_event(frame, &ev) == -ENOMEM) {
-				evdev_log_bug_libinput(
-					device,
-					"event frame overflow, discarding events.\n");
-			}
-			evdev_device_dispatch_frame(libinput, device, frame);
-			evdev_frame_reset(frame);
+		rc = 0;
+		for (size_t i = 0; i < nevents; i++) {
+			struct input_event *ev = &events[i];
 
-			rc = evdev_sync_device(libinput, device);
-			if (rc == 0)
-				rc = LIBEVDEV_READ_STATUS_SUCCESS;
-		} else if (rc == LIBEVDEV_READ_STATUS_SUCCESS) {
 			if (!once) {
-				evdev_note_time_delay(device, &ev);
+				evdev_note_time_delay(device, ev);
 				once = true;
 			}
 
-			if (evdev_frame_append_input_event(frame, &ev) == -ENOMEM) {
+			if (ev->type == EV_SYN && ev->code == SYN_DROPPED) {
+				/* Anything after the SYN_DROPPED is stale,
+				 * the sync gives us the current state */
+				rc = evdev_device_handle_syn_dropped(device,
+								     frame,
+								     ev);
+				break;
+			}
+
+			if (!evdev_update_libevdev_state(device->evdev, ev))
+				continue;
+
+			if (evdev_frame_append_input_event(frame, ev) == -ENOMEM) {
 				evdev_log_bug_libinput(
 					device,
 					"event frame overflow, discarding events.\n");
 			}
-			if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
-				evdev_device_dispatch_frame(libinput, device, frame);
+			if (ev->type == EV_SYN && ev->code == SYN_REPORT) {
+				libinput->stats.read_frames++;
+				evdev_device_dispatch_frame_timed(libinput,
+								  device,
+								  frame,
+								  ev);
 				evdev_frame_reset(frame);
 			}
-		} else if (rc == -ENODEV) {
-			evdev_device_remove(device);
-			return;
 		}
-	} while (rc == LIBEVDEV_READ_STATUS_SUCCESS);
+
+		if (rc < 0)
+			break;
+
+		/* A short read means the kernel buffer is drained, no need
+		 * for another read() just to get EAGAIN */
+		if (nevents < want) {
+			rc = -EAGAIN;
+			break;
+		}
+
+		if (budget) {
+			remaining -= nevents;
+			if (remaining == 0) {
+				libinput->stats.dispatch_budget_exhausted++;
+				break;
+			}
+		}
+	} while (rc == 0);
+
+	if (rc == -ENODEV) {
+		evdev_device_remove(device);
+		return;
+	}
 
 	/* This should never happen, the kernel flushes only on SYN_REPORT */
-	if (evdev_frame_get_count(frame) > 1) {
+	if (rc == -EAGAIN && evdev_frame_get_count(frame) > 1) {
 		evdev_log_bug_kernel(
 			device,
 			"event frame missing SYN_REPORT, forcing frame.\n");
 		evdev_device_dispatch_frame(libinput, device, frame);
+		evdev_frame_reset(frame);
 	}
 
-	if (rc != -EAGAIN && rc != -EINTR) {
-		libinput_remove_source(libinput, device->source);
-		device->source = NULL;
+	if (rc < 0 && rc != -EAGAIN && rc != -EINTR)
+		evdev_device_remove_source(device);
+}
+
+static bool
+evdev_device_add_source(struct evdev_device *device, int fd)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+	/* Keyboards and switches have a low event rate but are the most
+	 * latency-sensitive, see LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS */
+	bool prioritize =
+		device->seat_caps & (EVDEV_DEVICE_KEYBOARD | EVDEV_DEVICE_SWITCH);
+
+	if (libinput->reader) {
+		device->reader_device = reader_thread_add_device(libinput->reader,
+								 fd,
+								 evdev_device_dispatch,
+								 device);
+		if (!device->reader_device)
+			return false;
+
+		if (prioritize)
+			reader_device_set_priority(device->reader_device,
+						   LIBINPUT_SOURCE_PRIORITY_HIGH);
+		return true;
 	}
+
+	if (libinput->uring) {
+		device->uring_source = libinput_uring_add_source(libinput->uring,
+								 fd,
+								 evdev_device_dispatch,
+								 device);
+		if (device->uring_source) {
+			if (prioritize)
+				libinput_uring_source_set_priority(
+					device->uring_source,
+					LIBINPUT_SOURCE_PRIORITY_HIGH);
+			return true;
+		}
+		/* fall back to epoll for this device */
+	}
+
+	device->source = libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
+	if (!device->source)
+		return false;
+
+	if (prioritize)
+		libinput_source_set_priority(device->source,
+					     LIBINPUT_SOURCE_PRIORITY_HIGH);
+
+	return true;
 }
 
 static inline bool
@@ -2302,8 +2571,8 @@ libevdev_log_func(const struct libevdev *evdev,
 #pragma GCC diagnostic pop
 }
 
-static bool
-udev_device_should_be_ignored(struct udev_device *udev_device)
+bool
+evdev_udev_device_should_be_ignored(struct udev_device *udev_device)
 {
 	const char *value;
 
@@ -2312,8 +2581,168 @@ udev_device_should_be_ignored(struct udev_device *udev_device)
 	return value && !streq(value, "0");
 }
 
+/* Below this many devices it's not worth starting threads */
+#define EVDEV_PROBE_MIN_PARALLEL 4
+#define EVDEV_PROBE_MAX_THREADS 8
+
+void
+evdev_probe_open(struct libinput *libinput,
+		 struct evdev_probe *probe,
+		 struct udev_device *udev_device)
+{
+	const char *devnode = udev_device_get_devnode(udev_device);
+	int fd;
+
+	*probe = (struct evdev_probe){
+		.udev_device = udev_device,
+		.fd = -1,
+		.error = 0,
+		.evdev = NULL,
+		.quirks = NULL,
+		.quirks_fetched = false,
+		.libwacom = false,
+	};
+
+	if (!devnode || evdev_udev_device_should_be_ignored(udev_device))
+		return;
+
+	fd = open_restricted(libinput, devnode, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		probe->error = fd;
+		return;
+	}
+
+	if (!evdev_device_have_same_syspath(udev_device, fd)) {
+		close_restricted(libinput, fd);
+		return;
+	}
+
+	probe->fd = fd;
+}
+
+static void
+evdev_probe_run(struct evdev_probe *probe)
+{
+	if (probe->fd < 0)
+		return;
+
+	evdev_drain_fd(probe->fd);
+
+	if (libevdev_new_from_fd(probe->fd, &probe->evdev) != 0)
+		probe->evdev = NULL;
+}
+
+struct evdev_probe_queue {
+	struct evdev_probe *probes;
+	size_t nprobes;
+	atomic_size_t next;
+};
+
+static void *
+evdev_probe_thread(void *data)
+{
+	struct evdev_probe_queue *queue = data;
+	size_t idx;
+
+	while ((idx = atomic_fetch_add(&queue->next, 1)) < queue->nprobes)
+		evdev_probe_run(&queue->probes[idx]);
+
+	return NULL;
+}
+
+/* The part of the probe that needs the libinput context, done by the
+ * libinput thread while the workers read the device capabilities */
+static void
+evdev_probe_prefetch(struct libinput *libinput,
+		     struct evdev_probe *probes,
+		     size_t nprobes)
+{
+	for (size_t i = 0; i < nprobes; i++) {
+		struct evdev_probe *probe = &probes[i];
+
+		if (probe->fd < 0)
+			continue;
+
+		probe->quirks = quirks_fetch_for_device(libinput->quirks,
+							probe->udev_device);
+		probe->quirks_fetched = true;
+
+		/* Loads the database before the first tablet needs it,
+		 * the probe keeps it loaded until the device holds its
+		 * own reference */
+		if (udev_device_get_property_value(probe->udev_device,
+						   "ID_INPUT_TABLET") ||
+		    udev_device_get_property_value(probe->udev_device,
+						   "ID_INPUT_TABLET_PAD"))
+			probe->libwacom = libinput_libwacom_ref(libinput) != NULL;
+	}
+}
+
+void
+evdev_probe_run_all(struct libinput *libinput,
+		    struct evdev_probe *probes,
+		    size_t nprobes)
+{
+	struct evdev_probe_queue queue = {
+		.probes = probes,
+		.nprobes = nprobes,
+	};
+	pthread_t threads[EVDEV_PROBE_MAX_THREADS - 1];
+	size_t nthreads = 0;
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	atomic_init(&queue.next, 0);
+
+	if (nprobes >= EVDEV_PROBE_MIN_PARALLEL && ncpus > 1) {
+		size_t want = min((size_t)ncpus, (size_t)EVDEV_PROBE_MAX_THREADS);
+
+		/* The calling thread is one of the workers */
+		for (size_t i = 0; i < want - 1; i++) {
+			if (pthread_create(&threads[nthreads],
+					   NULL,
+					   evdev_probe_thread,
+					   &queue) != 0)
+				break;
+			nthreads++;
+		}
+	}
+
+	evdev_probe_prefetch(libinput, probes, nprobes);
+	evdev_probe_thread(&queue);
+
+	for (size_t i = 0; i < nthreads; i++)
+		pthread_join(threads[i], NULL);
+}
+
+void
+evdev_probe_release(struct libinput *libinput, struct evdev_probe *probe)
+{
+	if (probe->evdev) {
+		libevdev_free(probe->evdev);
+		probe->evdev = NULL;
+	}
+
+	probe->quirks = quirks_unref(probe->quirks);
+
+	if (probe->libwacom) {
+		libinput_libwacom_unref(libinput);
+		probe->libwacom = false;
+	}
+
+	if (probe->fd >= 0)
+		close_restricted(libinput, steal_fd(&probe->fd));
+}
+
 struct evdev_device *
 evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
+{
+	return evdev_device_create_from_probe(seat, udev_device, NULL);
+}
+
+struct evdev_device *
+evdev_device_create_from_probe(struct libinput_seat *seat,
+			       struct udev_device *udev_device,
+			       struct evdev_probe *probe)
 {
 	struct libinput *libinput = seat->libinput;
 	struct evdev_device *device = NULL;
@@ -2328,38 +2757,69 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 		goto err;
 	}
 
-	if (udev_device_should_be_ignored(udev_device)) {
+	if (evdev_udev_device_should_be_ignored(udev_device)) {
 		log_debug(libinput, "%s: device is ignored\n", sysname);
 		goto err;
 	}
 
-	/* Use non-blocking mode so that we can loop on read on
-	 * evdev_device_data() until all events on the fd are
-	 * read. */
-	fd = open_restricted(libinput, devnode, O_RDWR | O_NONBLOCK | O_CLOEXEC);
-	if (fd < 0) {
-		log_info(libinput,
-			 "%s: opening input device '%s' failed (%s).\n",
-			 sysname,
-			 devnode,
-			 strerror(-fd));
-		goto err;
-	}
+	if (probe) {
+		/* Whatever failed in evdev_probe_open() would fail again,
+		 * don't open the device a second time */
+		if (probe->fd < 0) {
+			if (probe->error < 0)
+				log_info(libinput,
+					 "%s: opening input device '%s' failed (%s).\n",
+					 sysname,
+					 devnode,
+					 strerror(-probe->error));
+			goto err;
+		}
+		fd = steal_fd(&probe->fd);
+	} else {
+		/* Use non-blocking mode so that we can loop on read on
+		 * evdev_device_data() until all events on the fd are
+		 * read. */
+		fd = open_restricted(libinput,
+				     devnode,
+				     O_RDWR | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) {
+			log_info(libinput,
+				 "%s: opening input device '%s' failed (%s).\n",
+				 sysname,
+				 devnode,
+				 strerror(-fd));
+			goto err;
+		}
 
-	if (!evdev_device_have_same_syspath(udev_device, fd))
-		goto err;
+		if (!evdev_device_have_same_syspath(udev_device, fd))
+			goto err;
+	}
 
 	device = zalloc(sizeof *device);
 	device->sysname = steal(&sysname);
+	device->read_frame = evdev_frame_new(64);
 
 	libinput_device_init(&device->base, seat);
 	libinput_seat_ref(seat);
 
-	evdev_drain_fd(fd);
+	if (probe && probe->quirks_fetched)
+		device->base.quirks = steal(&probe->quirks);
+	else
+		device->base.quirks = quirks_fetch_for_device(libinput->quirks,
+							      udev_device);
+	device->base.quirks_fetched = true;
+
+	if (probe) {
+		if (!probe->evdev)
+			goto err;
+		device->evdev = steal(&probe->evdev);
+	} else {
+		evdev_drain_fd(fd);
 
-	rc = libevdev_new_from_fd(fd, &device->evdev);
-	if (rc != 0)
-		goto err;
+		rc = libevdev_new_from_fd(fd, &device->evdev);
+		if (rc != 0)
+			goto err;
+	}
 
 	libevdev_set_clock_id(device->evdev, CLOCK_MONOTONIC);
 	libevdev_set_device_log_function(device->evdev,
@@ -2427,8 +2887,7 @@ evdev_device_create(struct libinput_seat *seat, struct udev_device *udev_device)
 	    device->seat_caps == EVDEV_DEVICE_NO_CAPABILITIES)
 		goto err_notify;
 
-	device->source = libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
-	if (!device->source)
+	if (!evdev_device_add_source(device, fd))
 		goto err_notify;
 
 	if (!evdev_set_device_group(device, udev_device))
@@ -2932,15 +3391,30 @@ evdev_device_suspend(struct evdev_device *device)
 	if (device->dispatch->interface->suspend)
 		device->dispatch->interface->suspend(device->dispatch, device);
 
-	if (device->source) {
-		libinput_remove_source(libinput, device->source);
-		device->source = NULL;
-	}
+	evdev_device_remove_source(device);
 
 	if (device->fd != -1) {
 		close_restricted(libinput, device->fd);
 		device->fd = -1;
 	}
+
+	/* Discard any partially read frame, we re-sync on resume */
+	evdev_frame_reset(device->read_frame);
+}
+
+/* A different device may have taken over the node while we had it closed */
+static bool
+evdev_device_have_same_id(struct evdev_device *device, int fd)
+{
+	struct input_id id;
+
+	if (ioctl(fd, EVIOCGID, &id) < 0)
+		return false;
+
+	return id.bustype == libevdev_get_id_bustype(device->evdev) &&
+	       id.vendor == libevdev_get_id_vendor(device->evdev) &&
+	       id.product == libevdev_get_id_product(device->evdev) &&
+	       id.version == libevdev_get_id_version(device->evdev);
 }
 
 int
@@ -2967,7 +3441,8 @@ evdev_device_resume(struct evdev_device *device)
 	if (fd < 0)
 		return -errno;
 
-	if (!evdev_device_have_same_syspath(device->udev_device, fd)) {
+	if (!evdev_device_have_same_syspath(device->udev_device, fd) ||
+	    !evdev_device_have_same_id(device, fd)) {
 		close_restricted(libinput, fd);
 		return -ENODEV;
 	}
@@ -2988,8 +3463,7 @@ evdev_device_resume(struct evdev_device *device)
 					     &ev);
 	} while (status == LIBEVDEV_READ_STATUS_SYNC);
 
-	device->source = libinput_add_fd(libinput, fd, evdev_device_dispatch, device);
-	if (!device->source)
+	if (!evdev_device_add_source(device, fd))
 		return -ENOMEM;
 
 	evdev_notify_resumed_device(device);
@@ -3021,6 +3495,10 @@ evdev_device_remove(struct evdev_device *device)
 	if (device->dispatch->interface->remove)
 		device->dispatch->interface->remove(device->dispatch);
 
+	/* Must be released before the quirks context, the device may
+	 * outlive the libinput context */
+	device->base.quirks = quirks_unref(device->base.quirks);
+
 	/* A device may be removed while suspended, mark it to
 	 * skip re-opening a different device with the same node */
 	device->was_removed = true;
@@ -3043,6 +3521,7 @@ evdev_device_destroy(struct evdev_device *device)
 	if (device->base.group)
 		libinput_device_group_unref(device->base.group);
 
+	quirks_unref(device->base.quirks);
 	free(device->log_prefix_name);
 	free(device->sysname);
 	free(device->output_name);
@@ -3052,5 +3531,6 @@ evdev_device_destroy(struct evdev_device *device)
 	libinput_seat_unref(device->base.seat);
 	libevdev_free(device->evdev);
 	udev_device_unref(device->udev_device);
+	evdev_frame_unref(device->read_frame);
 	free(device);
 }
@@ -170,6 +170,10 @@ struct evdev_device {
 	struct libinput_device base;
 
 	struct libinput_source *source;
+	/* Used instead of source if the reader thread is enabled */
+	struct reader_device *reader_device;
+	/* Used instead of source if libinput reads through io_uring */
+	struct libinput_uring_source *uring_source;
 
 	struct evdev_dispatch *dispatch;
 	struct libevdev *evdev;
@@ -184,10 +188,16 @@ struct evdev_device {
 	enum evdev_device_tags tags;
 	bool is_mt;
 	bool is_suspended;
+	/* Suspended by libinput_suspend() with fast resume, see
+	 * libinput_udev_set_fast_resume() */
+	bool is_suspended_with_context;
 	int dpi;                      /* HW resolution */
 	double trackpoint_multiplier; /* trackpoint constant multiplier */
 	bool use_velocity_averaging;  /* whether averaging should be applied on velocity
 					 calculation */
+	/* The frame currently being read, may be incomplete across calls to
+	 * evdev_device_dispatch() if the dispatch budget ran out */
+	struct evdev_frame *read_frame;
 	struct ratelimit syn_drop_limit; /* ratelimit for SYN_DROPPED logging */
 	struct ratelimit
 		delay_warning_limit; /* ratelimit for delayd processing logging */
@@ -388,6 +398,62 @@ evdev_verify_dispatch_type(struct evdev_dispatch *dispatch,
 struct evdev_device *
 evdev_device_create(struct libinput_seat *seat, struct udev_device *device);
 
+/**
+ * True if the device is tagged with LIBINPUT_IGNORE_DEVICE
+ */
+bool
+evdev_udev_device_should_be_ignored(struct udev_device *udev_device);
+
+/**
+ * The part of device creation that doesn't need the libinput context:
+ * reading the device's capabilities through a series of ioctls. When
+ * adding many devices at once this runs on worker threads, see
+ * evdev_probe_run_all().
+ */
+struct evdev_probe {
+	struct udev_device *udev_device; /* not ref'd */
+	int fd; /* -1 if not opened */
+	int error; /* negative errno if open_restricted() failed */
+	struct libevdev *evdev; /* NULL if not probed */
+	struct quirks *quirks;
+	bool quirks_fetched;
+	bool libwacom; /* holds a libinput_libwacom_ref() */
+};
+
+/**
+ * Open the device for evdev_probe_run_all(). Must be called from the
+ * libinput thread since it calls open_restricted(). Any failure
+ * leaves probe->fd at -1, evdev_device_create_from_probe() then logs
+ * probe->error and doesn't open the device again.
+ */
+void
+evdev_probe_open(struct libinput *libinput,
+		 struct evdev_probe *probe,
+		 struct udev_device *udev_device);
+
+/**
+ * Probe all opened devices, in parallel if there are enough of them.
+ * The worker threads don't touch the libinput context, the calling
+ * thread fetches the quirks and loads the libwacom database while they
+ * run. Returns once all devices are probed.
+ */
+void
+evdev_probe_run_all(struct libinput *libinput,
+		    struct evdev_probe *probes,
+		    size_t nprobes);
+
+/**
+ * Release whatever of the probe wasn't taken over by
+ * evdev_device_create_from_probe().
+ */
+void
+evdev_probe_release(struct libinput *libinput, struct evdev_probe *probe);
+
+struct evdev_device *
+evdev_device_create_from_probe(struct libinput_seat *seat,
+			       struct udev_device *device,
+			       struct evdev_probe *probe);
+
 static inline struct libinput *
 evdev_libinput_context(const struct evdev_device *device)
 {
@@ -273,7 +273,8 @@ debounce_notify_button(struct plugin_device *device,
 {
 	_unref_(evdev_frame) *button_frame = NULL;
 	if (frame == NULL) {
-		button_frame = evdev_frame_new(2);
+		button_frame =
+			libinput_plugin_evdev_frame_new(device->parent->plugin, 2);
 		frame = button_frame;
 	}
 
@@ -641,6 +642,17 @@ debounce_plugin_handle_frame(struct plugin_device *device,
 	size_t nevents;
 	struct evdev_event *events = evdev_frame_get_events(frame, &nevents);
 
+	/* Most frames don't have buttons and pass through unmodified */
+	bool has_buttons = false;
+	for (size_t i = 0; i < nevents; i++) {
+		if (evdev_usage_is_button(events[i].usage)) {
+			has_buttons = true;
+			break;
+		}
+	}
+	if (!has_buttons)
+		return;
+
 	/* Strip out all button events from this frame (if any). Then
 	 * append the button events to that stripped frame according
 	 * to our state machine.
@@ -648,7 +660,8 @@ debounce_plugin_handle_frame(struct plugin_device *device,
 	 * We allow for a max of 16 buttons to be appended, if you press more
 	 * than 16 buttons within the same frame good luck to you.
 	 */
-	_unref_(evdev_frame) *filtered_frame = evdev_frame_new(nevents + 16);
+	_unref_(evdev_frame) *filtered_frame =
+		libinput_plugin_evdev_frame_new(device->parent->plugin, nevents + 16);
 	for (size_t i = 0; i < nevents; i++) {
 		struct evdev_event *e = &events[i];
 		if (!evdev_usage_is_button(e->usage)) {
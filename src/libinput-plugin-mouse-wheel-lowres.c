@@ -71,7 +71,8 @@ wheel_plugin_evdev_frame(struct libinput_plugin *libinput_plugin,
 	size_t nevents;
 	struct evdev_event *events = evdev_frame_get_events(frame, &nevents);
 
-	_unref_(evdev_frame) *filtered_frame = evdev_frame_new(nevents + 2);
+	_unref_(evdev_frame) *filtered_frame =
+		libinput_plugin_evdev_frame_new(libinput_plugin, nevents + 2);
 	for (size_t i = 0; i < nevents; i++) {
 		struct evdev_event *e = &events[i];
 
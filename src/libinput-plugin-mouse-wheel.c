@@ -259,11 +259,15 @@ wheel_handle_event(struct plugin_device *pd, enum wheel_event event, usec_t time
 }
 
 static void
-wheel_remove_scroll_events(struct evdev_frame *frame)
+wheel_remove_scroll_events(struct plugin_device *pd, struct evdev_frame *frame)
 {
 	size_t nevents;
-	_unref_(evdev_frame) *copy = evdev_frame_clone(frame);
-	struct evdev_event *events = evdev_frame_get_events(copy, &nevents);
+	struct evdev_event *events = evdev_frame_get_events(frame, &nevents);
+	_unref_(evdev_frame) *copy =
+		libinput_plugin_evdev_frame_new(pd->parent->plugin, nevents);
+
+	evdev_frame_set(copy, events, nevents);
+	events = evdev_frame_get_events(copy, &nevents);
 
 	evdev_frame_reset(frame);
 
@@ -328,7 +332,7 @@ wheel_handle_state_accumulating_scroll(struct plugin_device *pd,
 				       struct evdev_frame *frame,
 				       usec_t time)
 {
-	wheel_remove_scroll_events(frame);
+	wheel_remove_scroll_events(pd, frame);
 
 	if (abs(pd->hi_res.x) > pd->min_movement ||
 	    abs(pd->hi_res.y) > pd->min_movement) {
@@ -342,7 +346,7 @@ wheel_handle_state_scrolling(struct plugin_device *pd,
 			     struct evdev_frame *frame,
 			     usec_t time)
 {
-	wheel_remove_scroll_events(frame);
+	wheel_remove_scroll_events(pd, frame);
 	wheel_queue_scroll_events(pd, frame);
 }
 
@@ -38,6 +38,9 @@ enum libinput_feature;
 struct libinput;
 struct libinput_plugin;
 
+/* Limited by the size of libinput_device->plugin_frame_callbacks */
+#define LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS 32
+
 struct libinput_plugin_system {
 	char **directories; /* NULL once loaded == true */
 
@@ -48,6 +51,20 @@ struct libinput_plugin_system {
 	struct list removed_plugins;
 
 	size_t next_plugin_index; /* sequential index of all plugins */
+
+	/* Bumped whenever the list of plugins changes, a device's
+	 * plugin_routes are rebuilt if their serial doesn't match */
+	uint32_t routes_serial;
+	/* Nesting level of evdev frame notifications, unregistered
+	 * plugins are only dropped once we're back at zero */
+	unsigned int frame_depth;
+
+	/* Recycled struct plugin_queued_event, see plugin_queued_event_new() */
+	struct list queued_event_pool;
+	size_t queued_event_pool_size;
+
+	/* See libinput_plugin_evdev_frame_new() */
+	struct evdev_frame_pool frame_pool;
 };
 
 void
@@ -105,7 +105,8 @@ double_tool_plugin_filter_frame(struct libinput_plugin *plugin,
 	struct evdev_event *events = evdev_frame_get_events(frame_in, &nevents);
 
 	/* +2 because we may add BTN_TOOL_PEN and BTN_TOOL_RUBBER */
-	struct evdev_frame *frame_out = evdev_frame_new(nevents + 2);
+	struct evdev_frame *frame_out =
+		libinput_plugin_evdev_frame_new(plugin, nevents + 2);
 	evdev_frame_set_time(frame_out, evdev_frame_get_time(frame_in));
 
 	for (size_t i = 0; i < nevents; i++) {
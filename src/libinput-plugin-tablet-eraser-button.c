@@ -188,7 +188,8 @@ eraser_button_insert_frame(struct plugin_device *device,
 	const struct evdev_event *events = evdev_frame_get_events(frame_in, &nevents);
 
 	/* +2 because we may add BTN_TOOL_PEN and BTN_TOOL_RUBBER */
-	_unref_(evdev_frame) *frame_out = evdev_frame_new(nevents + 2);
+	_unref_(evdev_frame) *frame_out =
+		libinput_plugin_evdev_frame_new(device->parent->plugin, nevents + 2);
 
 	for (size_t i = 0; i < nevents; i++) {
 		struct evdev_event event = events[i];
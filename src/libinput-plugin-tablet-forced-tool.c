@@ -96,7 +96,8 @@ forced_tool_plugin_force_pen_out(struct libinput_plugin *libinput_plugin,
 				 struct libinput_device *device,
 				 struct evdev_frame *frame)
 {
-	_unref_(evdev_frame) *prox_out_frame = evdev_frame_new(2);
+	_unref_(evdev_frame) *prox_out_frame =
+		libinput_plugin_evdev_frame_new(libinput_plugin, 2);
 	evdev_frame_append_one(prox_out_frame, evdev_usage_from(EVDEV_BTN_TOOL_PEN), 0);
 	evdev_frame_set_time(prox_out_frame, evdev_frame_get_time(frame));
 
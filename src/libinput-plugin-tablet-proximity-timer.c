@@ -115,7 +115,8 @@ tablet_proximity_out_quirk_timer_func(struct libinput_plugin *plugin,
 			 "%s: forcing proximity out after timeout\n",
 			 libinput_device_get_name(device->device));
 
-	_unref_(evdev_frame) *prox_out_frame = evdev_frame_new(2);
+	_unref_(evdev_frame) *prox_out_frame =
+		libinput_plugin_evdev_frame_new(device->parent->plugin, 2);
 	evdev_frame_append_one(prox_out_frame, evdev_usage_from(EVDEV_BTN_TOOL_PEN), 0);
 	evdev_frame_set_time(prox_out_frame, now);
 
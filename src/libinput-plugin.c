@@ -118,8 +118,10 @@ libinput_plugin_new(struct libinput *libinput,
 	plugin->name = safe_strdup(name);
 	list_init(&plugin->timers);
 
-	if (plugin->index >= 32) {
-		log_bug_libinput(libinput, "Too many plugins, maximum is 32\n");
+	if (plugin->index >= LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS) {
+		log_bug_libinput(libinput,
+				 "Too many plugins, maximum is %d\n",
+				 LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS);
 	}
 
 	libinput_plugin_system_register_plugin(&libinput->plugin_system, plugin);
@@ -202,6 +204,9 @@ libinput_plugin_enable_device_event_frame(struct libinput_plugin *plugin,
 	} else {
 		bitmask_clear_bit(&device->plugin_frame_callbacks, plugin->index);
 	}
+
+	/* Force a rebuild of this device's routes */
+	device->plugin_routes.serial = 0;
 }
 
 void
@@ -230,27 +235,68 @@ libinput_plugin_disable_device_feature(struct libinput_plugin *plugin,
 	bitmask_set_bit(&device->disabled_features, feature);
 }
 
+/* Upper limit of recycled queued events, anything above is freed */
+#define PLUGIN_QUEUED_EVENT_POOL_MAX 32
+
 struct plugin_queued_event {
 	struct list link;
-	struct evdev_frame *frame;      /* owns a ref */
+	struct libinput_plugin_system *system;
+	struct evdev_frame *frame;      /* owns a ref, may be shared */
 	struct libinput_device *device; /* owns a ref */
+	/* The frame as it was queued, only compared against to detect
+	 * copy-on-write copies, never dereferenced */
+	const struct evdev_frame *queued_frame;
 };
 
 static void
 plugin_queued_event_destroy(struct plugin_queued_event *event)
 {
-	evdev_frame_unref(event->frame);
+	struct libinput_plugin_system *system = event->system;
+
+	evdev_frame_release_shared(&event->frame);
 	libinput_device_unref(event->device);
 	list_remove(&event->link);
-	free(event);
+
+	if (system->queued_event_pool_size < PLUGIN_QUEUED_EVENT_POOL_MAX) {
+		list_append(&system->queued_event_pool, &event->link);
+		system->queued_event_pool_size++;
+	} else {
+		free(event);
+	}
 }
 
+/**
+ * Queue events are created and destroyed for every frame that passes
+ * through a plugin so they are recycled instead of allocated.
+ *
+ * If share is true the frame is shared copy-on-write with the queued
+ * event (see evdev_frame_share()), otherwise the queued event takes a
+ * plain reference and the frame is considered owned by the pipeline.
+ */
 static inline struct plugin_queued_event *
-plugin_queued_event_new(struct evdev_frame *frame, struct libinput_device *device)
+plugin_queued_event_new(struct libinput_plugin_system *system,
+			struct evdev_frame *frame,
+			struct libinput_device *device,
+			bool share)
 {
-	struct plugin_queued_event *event = zalloc(sizeof(*event));
+	struct plugin_queued_event *event;
+
+	if (!list_empty(&system->queued_event_pool)) {
+		event = list_first_entry_by_type(&system->queued_event_pool,
+						 struct plugin_queued_event,
+						 link);
+		list_remove(&event->link);
+		system->queued_event_pool_size--;
+	} else {
+		event = zalloc(sizeof(*event));
+	}
 
-	event->frame = evdev_frame_ref(frame);
+	event->system = system;
+	event->queued_frame = frame;
+	if (share)
+		evdev_frame_share(frame, &event->frame);
+	else
+		event->frame = evdev_frame_ref(frame);
 	event->device = libinput_device_ref(device);
 
 	return event;
@@ -271,11 +317,23 @@ libinput_plugin_queue_evdev_frame(struct list *queue,
 		return;
 	}
 
-	_unref_(evdev_frame) *clone = evdev_frame_clone(frame);
-	struct plugin_queued_event *event = plugin_queued_event_new(clone, device);
+	/* The plugin may keep modifying its frame after queuing it, so
+	 * the frame is shared copy-on-write rather than cloned up-front */
+	struct plugin_queued_event *event =
+		plugin_queued_event_new(&plugin->libinput->plugin_system,
+					frame,
+					device,
+					true);
 	list_take_append(queue, event, link);
 }
 
+struct evdev_frame *
+libinput_plugin_evdev_frame_new(struct libinput_plugin *plugin, size_t max_size)
+{
+	return evdev_frame_new_pooled(&plugin->libinput->plugin_system.frame_pool,
+				      max_size);
+}
+
 void
 libinput_plugin_append_evdev_frame(struct libinput_plugin *plugin,
 				   struct libinput_device *device,
@@ -447,12 +505,21 @@ libinput_plugin_system_run(struct libinput_plugin_system *system)
 	}
 }
 
+static void
+plugin_system_invalidate_routes(struct libinput_plugin_system *system)
+{
+	/* 0 is reserved for "never built" */
+	if (++system->routes_serial == 0)
+		system->routes_serial = 1;
+}
+
 void
 libinput_plugin_system_register_plugin(struct libinput_plugin_system *system,
 				       struct libinput_plugin *plugin)
 {
 	libinput_plugin_ref(plugin);
 	list_append(&system->plugins, &plugin->link);
+	plugin_system_invalidate_routes(system);
 }
 
 void
@@ -464,6 +531,7 @@ libinput_plugin_system_unregister_plugin(struct libinput_plugin_system *system,
 		if (p == plugin) {
 			list_remove(&plugin->link);
 			list_append(&system->removed_plugins, &plugin->link);
+			plugin_system_invalidate_routes(system);
 			return;
 		}
 	}
@@ -472,6 +540,10 @@ libinput_plugin_system_unregister_plugin(struct libinput_plugin_system *system,
 static void
 libinput_plugin_system_drop_unregistered_plugins(struct libinput_plugin_system *system)
 {
+	/* Frame processing may still be walking a device's routes */
+	if (system->frame_depth > 0)
+		return;
+
 	struct libinput_plugin *plugin;
 	list_for_each_safe(plugin, &system->removed_plugins, link) {
 		list_remove(&plugin->link);
@@ -491,6 +563,11 @@ libinput_plugin_system_init(struct libinput_plugin_system *system)
 #endif
 	list_init(&system->plugins);
 	list_init(&system->removed_plugins);
+	list_init(&system->queued_event_pool);
+	system->queued_event_pool_size = 0;
+	system->frame_pool.count = 0;
+	system->routes_serial = 1;
+	system->frame_depth = 0;
 }
 
 static void
@@ -530,6 +607,16 @@ libinput_plugin_system_destroy(struct libinput_plugin_system *system)
 
 	libinput_plugin_system_drop_unregistered_plugins(system);
 
+	struct plugin_queued_event *event;
+	list_for_each_safe(event, &system->queued_event_pool, link) {
+		list_remove(&event->link);
+		free(event);
+	}
+	system->queued_event_pool_size = 0;
+
+	/* The frame pool is destroyed in libinput_unref() once the
+	 * devices and their frames are gone */
+
 	strv_free(system->directories);
 }
 
@@ -623,30 +710,44 @@ libinput_plugin_system_notify_device_feature_disabled(
 	libinput_plugin_system_drop_unregistered_plugins(system);
 }
 
+/**
+ * Pass the queued event's frame to the plugin. The queued event is
+ * re-used for the resulting frame (if any) so a frame passed through
+ * unmodified only costs a list move.
+ */
 static void
 libinput_plugin_process_frame(struct libinput_plugin *plugin,
-			      struct libinput_device *device,
-			      struct evdev_frame *frame,
+			      struct plugin_queued_event *event,
 			      struct list *queued_events)
 {
 	struct list before_events = LIST_INIT(before_events);
 	struct list after_events = LIST_INIT(after_events);
+	struct evdev_frame *frame = evdev_frame_take_shared(&event->frame);
+
+	if (frame != event->queued_frame) {
+		plugin->libinput->stats.plugin_frame_copies++;
+		event->queued_frame = frame;
+	}
 
 	plugin->event_queue.before = &before_events;
 	plugin->event_queue.after = &after_events;
 
 	if (plugin->interface->evdev_frame)
-		plugin->interface->evdev_frame(plugin, device, frame);
+		plugin->interface->evdev_frame(plugin, event->device, frame);
 
 	plugin->event_queue.before = NULL;
 	plugin->event_queue.after = NULL;
 
 	list_chain(queued_events, &before_events);
 
-	if (!evdev_frame_is_empty(frame)) {
-		struct plugin_queued_event *event =
-			plugin_queued_event_new(frame, device);
-		list_take_append(queued_events, event, link);
+	/* The plugin may have queued its own frame, in which case the
+	 * queued copy was taken before any modifications and our frame
+	 * may have been reset */
+	if (!evdev_frame_is_empty(event->frame)) {
+		list_remove(&event->link);
+		list_append(queued_events, &event->link);
+	} else {
+		plugin_queued_event_destroy(event);
 	}
 
 	list_chain(queued_events, &after_events);
@@ -740,39 +841,79 @@ plugin_has_mask(struct libinput_plugin *plugin, struct evdev_frame *frame)
 	return false;
 }
 
+/**
+ * Rebuild the device's list of plugins with frame callbacks if the set
+ * of plugins or the device's callbacks changed since the last frame.
+ */
+static inline void
+plugin_system_update_routes(struct libinput_plugin_system *system,
+			    struct libinput_device *device)
+{
+	if (device->plugin_routes.serial == system->routes_serial)
+		return;
+
+	size_t nplugins = 0;
+	struct libinput_plugin *plugin;
+	list_for_each(plugin, &system->plugins, link) {
+		if (plugin->index >= LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS)
+			continue;
+		if (bitmask_bit_is_set(device->plugin_frame_callbacks, plugin->index))
+			device->plugin_routes.plugins[nplugins++] = plugin;
+	}
+
+	device->plugin_routes.nplugins = nplugins;
+	device->plugin_routes.serial = system->routes_serial;
+}
+
 static void
 plugin_system_notify_evdev_frame(struct libinput_plugin_system *system,
-				 struct libinput_device *device,
-				 struct evdev_frame *frame,
+				 struct plugin_queued_event *our_event,
 				 struct libinput_plugin *sender_plugin)
 {
+	/* our_event may be recycled before we're done with the device */
+	_unref_(libinput_device) *device = libinput_device_ref(our_event->device);
+
 	/* This is messy because a single event frame may cause
 	 * *each* plugin to generate multiple event frames for potentially
 	 * different devices and replaying is basically breadth-first traversal.
 	 *
-	 * So we have our event (passed in as 'frame') and we create a queue.
+	 * So we have our event (passed in as 'our_event') and we create a queue.
 	 * Each plugin then creates a new event list from each frame in the
 	 * queue.
+	 *
+	 * Our event is taken over and re-used for as long as its frame
+	 * passes through the plugins.
 	 */
-	struct plugin_queued_event *our_event = plugin_queued_event_new(frame, device);
+	usec_t frame_time = evdev_frame_get_time(our_event->frame);
 
 	struct list queued_events = LIST_INIT(queued_events);
 	list_take_insert(&queued_events, our_event, link);
 
-	usec_t frame_time = evdev_frame_get_time(frame);
+	/* Only the plugins with frame callbacks for this device are
+	 * walked. We work on a copy since a plugin may cause the routes to
+	 * be rebuilt (e.g. by injecting a frame), the plugins themselves
+	 * stay alive until we're back at frame_depth 0.
+	 */
+	plugin_system_update_routes(system, device);
 
-	bool delay = !!sender_plugin;
+	size_t nplugins = device->plugin_routes.nplugins;
+	struct libinput_plugin *plugins[LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS];
+	memcpy(plugins, device->plugin_routes.plugins, nplugins * sizeof(*plugins));
+
+	system->frame_depth++;
+
+	for (size_t i = 0; i < nplugins; i++) {
+		struct libinput_plugin *plugin = plugins[i];
+
+		if (!plugin->registered)
+			continue;
 
-	struct libinput_plugin *plugin;
-	list_for_each_safe(plugin, &system->plugins, link) {
 		/* We start processing *after* the sender plugin. sender_plugin
 		 * is only set if we're queuing (not injecting) events from
-		 * a plugin timer func
+		 * a plugin timer func. Plugin indices are in plugin order.
 		 */
-		if (delay) {
-			delay = plugin != sender_plugin;
+		if (sender_plugin && plugin->index <= sender_plugin->index)
 			continue;
-		}
 
 		/* The list of queued events for the *next* plugin */
 		struct list next_events = LIST_INIT(next_events);
@@ -787,8 +928,11 @@ plugin_system_notify_evdev_frame(struct libinput_plugin_system *system,
 		list_for_each_safe(event, &queued_events, link) {
 			struct list next = LIST_INIT(next);
 
-			if (usec_is_zero(evdev_frame_get_time(event->frame)))
-				evdev_frame_set_time(event->frame, frame_time);
+			if (usec_is_zero(evdev_frame_get_time(event->frame))) {
+				struct evdev_frame *f =
+					evdev_frame_take_shared(&event->frame);
+				evdev_frame_set_time(f, frame_time);
+			}
 
 			if (!bitmask_bit_is_set(device->plugin_frame_callbacks,
 						plugin->index) ||
@@ -808,21 +952,15 @@ plugin_system_notify_evdev_frame(struct libinput_plugin_system *system,
 				    prefix);
 #endif
 
-			libinput_plugin_process_frame(plugin,
-						      event->device,
-						      event->frame,
-						      &next);
+			libinput_plugin_process_frame(plugin, event, &next);
 
 			list_chain(&next_events, &next);
-			plugin_queued_event_destroy(event);
 		}
 		assert(list_empty(&queued_events));
 		list_chain(&queued_events, &next_events);
 		if (list_empty(&queued_events)) {
 #ifdef EVENT_DEBUGGING
-			if (list_last_entry_by_type(&system->plugins,
-						    struct libinput_plugin,
-						    link) != plugin) {
+			if (i != nplugins - 1) {
 				log_debug(
 					libinput_device_get_context(device),
 					"%s: --- empty frame queue - end of events ---\n",
@@ -838,7 +976,13 @@ plugin_system_notify_evdev_frame(struct libinput_plugin_system *system,
 	if (!list_empty(&queued_events)) {
 		log_bug_libinput(libinput_device_get_context(device),
 				 "Events left over to replay after last plugin\n");
+
+		struct plugin_queued_event *event;
+		list_for_each_safe(event, &queued_events, link)
+			plugin_queued_event_destroy(event);
 	}
+
+	system->frame_depth--;
 	libinput_plugin_system_drop_unregistered_plugins(system);
 }
 
@@ -847,7 +991,12 @@ libinput_plugin_system_notify_evdev_frame(struct libinput_plugin_system *system,
 					  struct libinput_device *device,
 					  struct evdev_frame *frame)
 {
-	plugin_system_notify_evdev_frame(system, device, frame, NULL);
+	struct plugin_queued_event *event =
+		plugin_queued_event_new(system, frame, device, false);
+
+	libinput_device_get_context(device)->stats.frames_processed++;
+
+	plugin_system_notify_evdev_frame(system, event, NULL);
 }
 
 static void
@@ -873,11 +1022,10 @@ plugin_timer_func(usec_t now, void *data)
 
 	struct plugin_queued_event *event;
 	list_for_each_safe(event, &before_events, link) {
+		list_remove(&event->link);
 		plugin_system_notify_evdev_frame(&libinput->plugin_system,
-						 event->device,
-						 event->frame,
+						 event,
 						 plugin);
-		plugin_queued_event_destroy(event);
 	}
 }
 
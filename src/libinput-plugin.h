@@ -277,6 +277,11 @@ libinput_plugin_inject_evdev_frame(struct libinput_plugin *libinput,
  * It is a plugin bug to call this function from outside the
  * evdev_frame() callback or a timer callback.
  *
+ * The frame is not copied, the queue shares the frame with the plugin
+ * until either side modifies it via the evdev_frame helpers. The
+ * plugin may thus keep using the frame after this call but must not
+ * modify it through the pointer returned by evdev_frame_get_events().
+ *
  * If called within a plugin's timer callback, any frames generated by
  * the plugin will only be seen by plugins after this plugin. These
  * frames will be processed in the usual evdev_frame() callback and there
@@ -313,6 +318,15 @@ libinput_plugin_prepend_evdev_frame(struct libinput_plugin *libinput,
 				    struct libinput_device *device,
 				    struct evdev_frame *frame);
 
+/**
+ * Create a new evdev frame for use by this plugin, see evdev_frame_new().
+ * The frame is taken from (and on its last unref returned to) a pool
+ * shared by all plugins so plugins creating a frame for every frame they
+ * process do not allocate in the steady state.
+ */
+struct evdev_frame *
+libinput_plugin_evdev_frame_new(struct libinput_plugin *plugin, size_t max_size);
+
 /**
  * Create a new timer for the given plugin.
  *
@@ -188,6 +188,31 @@ struct libinput_interface_backend {
 				  const char *seat_name);
 };
 
+/* One pool per event struct type, see event_pool_type_for() */
+enum event_pool_type {
+	EVENT_POOL_DEVICE_NOTIFY,
+	EVENT_POOL_KEYBOARD,
+	EVENT_POOL_POINTER,
+	EVENT_POOL_TOUCH,
+	EVENT_POOL_TOUCH_AGGREGATE,
+	EVENT_POOL_GESTURE,
+	EVENT_POOL_TABLET_TOOL,
+	EVENT_POOL_TABLET_TOOL_BATCH,
+	EVENT_POOL_TABLET_PAD,
+	EVENT_POOL_SWITCH,
+
+	EVENT_POOL_COUNT, /* must be last */
+};
+
+/* Max number of destroyed events we keep around per event struct type,
+ * anything beyond that is returned to the heap */
+#define EVENT_POOL_SIZE 128
+
+struct libinput_event_pool {
+	struct libinput_event *events[EVENT_POOL_SIZE];
+	size_t count;
+};
+
 struct libinput {
 	int epoll_fd;
 	struct list source_destroy_list;
@@ -195,8 +220,9 @@ struct libinput {
 	struct list seat_list;
 
 	struct {
-		struct list list;
+		struct heap heap;
 		struct libinput_source *source;
+		struct libinput_uring_source *uring_source;
 		int fd;
 		usec_t next_expiry;
 
@@ -208,9 +234,42 @@ struct libinput {
 	size_t events_len;
 	size_t events_in;
 	size_t events_out;
+	enum libinput_event_queue_overflow events_overflow;
+	bool events_coalesce;
+
+	/* See libinput_set_latency_stats_enabled() */
+	bool latency_stats;
+
+	/* One bitmask per group of event types, bit (type % 100) in
+	 * group (type / 100). See libinput_set_event_type_enabled() */
+	uint32_t disabled_event_types[10];
+
+	unsigned int dispatch_budget; /* events per device, 0 is unlimited */
+	uint32_t dispatch_flags;      /* enum libinput_dispatch_flags */
+
+	/* Reads the device fds if enabled, see
+	 * libinput_enable_reader_thread() */
+	struct reader_thread *reader;
+
+	/* Reads the device fds and the timerfd if libinput was built
+	 * with io_uring and the kernel supports it, NULL otherwise */
+	struct libinput_uring *uring;
+
+	struct libinput_event_pool event_pool[EVENT_POOL_COUNT];
+
+	struct libinput_stats stats;
 
 	struct list tool_list;
 
+	/* Tablet tools with serial numbers in tool_list, hashed on
+	 * (type, serial) */
+	struct {
+		struct list *buckets;
+		size_t nbuckets; /* power of two */
+		size_t count;
+		size_t evict_threshold;
+	} tool_index;
+
 	const struct libinput_interface *interface;
 	const struct libinput_interface_backend *interface_backend;
 
@@ -537,12 +596,34 @@ struct libinput_device {
 	struct libinput_device_config config;
 
 	bitmask_t plugin_frame_callbacks;
+	/**
+	 * The plugins with frame callbacks for this device, in plugin
+	 * order. Rebuilt on demand when the serial doesn't match the
+	 * plugin system's routes_serial.
+	 */
+	struct {
+		uint32_t serial;
+		size_t nplugins;
+		struct libinput_plugin *plugins[LIBINPUT_PLUGIN_SYSTEM_MAX_PLUGINS];
+	} plugin_routes;
 	/**
 	 * Lua plugins see the device before our internal
 	 * plugins do any calls need to be cached.
 	 */
 	bitmask_t disabled_features;
 
+	/* See libinput_device_get_latency_stats() */
+	struct libinput_latency_stats latency;
+
+	/* Fetched once when the device is created (may be NULL if no
+	 * quirks apply), see libinput_device_get_quirks() */
+	struct quirks *quirks;
+	bool quirks_fetched;
+
+	/* Not yet posted LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME event for
+	 * the current frame, see touch_notify_frame() */
+	struct libinput_event_touch_aggregate *touch_aggregate;
+
 	void (*inject_evdev_frame)(struct libinput_device *device,
 				   struct evdev_frame *frame);
 };
@@ -627,6 +708,7 @@ struct libinput_tablet_tool_pressure_threshold {
 
 struct libinput_tablet_tool {
 	struct list link;
+	struct list index_link; /* libinput->tool_index */
 	uint32_t serial;
 	uint32_t tool_id;
 	enum libinput_tablet_tool_type type;
@@ -716,6 +798,15 @@ libinput_add_fd(struct libinput *libinput,
 void
 libinput_remove_source(struct libinput *libinput, struct libinput_source *source);
 
+enum libinput_source_priority {
+	LIBINPUT_SOURCE_PRIORITY_DEFAULT = 0,
+	LIBINPUT_SOURCE_PRIORITY_HIGH,
+};
+
+void
+libinput_source_set_priority(struct libinput_source *source,
+			     enum libinput_source_priority priority);
+
 int
 open_restricted(struct libinput *libinput, const char *path, int flags);
 
@@ -1128,6 +1219,18 @@ point_in_rect(const struct device_coords *point, const struct device_coord_rect
 		point->y >= rect->y && point->y < rect->y + rect->h);
 }
 
+static inline void
+latency_histogram_add(struct libinput_latency_histogram *h, usec_t latency)
+{
+	uint64_t us = usec_as_uint64_t(latency);
+	size_t bucket = us ? 64 - __builtin_clzll(us) : 0;
+
+	h->count++;
+	h->sum_us += us;
+	h->max_us = max(h->max_us, us);
+	h->buckets[min(bucket, ARRAY_LENGTH(h->buckets) - 1)]++;
+}
+
 #ifdef HAVE_LIBWACOM
 WacomDeviceDatabase *
 libinput_libwacom_ref(struct libinput *li);
@@ -0,0 +1,518 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <liburing.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "linux/input.h"
+
+#include "libinput-private.h"
+#include "libinput-uring.h"
+
+#define URING_QUEUE_DEPTH 64
+/* Number of buffers per fd, a power of two. Each fd has its own buffer
+ * group so a device that isn't drained (see the dispatch budget) can
+ * only ever run out of its own buffers. */
+#define URING_NBUFFERS 16
+/* A multiple of the input event size so the kernel never splits an
+ * event across buffers, 3kB on 64-bit */
+#define URING_BUFFER_SIZE (128 * sizeof(struct input_event))
+
+struct libinput_uring_source {
+	struct libinput_uring *uring;
+	struct list link; /* uring->sources */
+	int fd;
+	libinput_source_dispatch_t dispatch;
+	void *user_data;
+	enum libinput_source_priority priority;
+
+	uint16_t bgid;
+	struct io_uring_buf_ring *buf_ring;
+	char *buffers;
+	size_t nbuffers_available;
+
+	bool armed;      /* a multishot read is outstanding */
+	bool removed;    /* freed once the outstanding read terminated */
+	bool paused;     /* not re-armed until resumed */
+	bool cancelling; /* data read until the read terminated is dropped */
+	int error;    /* negative errno once the read failed */
+
+	/* Buffers filled by the kernel in order, not yet consumed */
+	struct {
+		uint16_t bid;
+		uint32_t len;
+	} pending[URING_NBUFFERS];
+	size_t pending_first;
+	size_t npending;
+	size_t offset; /* bytes consumed of the first pending buffer */
+};
+
+struct libinput_uring {
+	struct libinput *libinput;
+	struct io_uring ring;
+
+	int eventfd;
+	struct libinput_source *source;
+
+	struct list sources;
+};
+
+static inline void *
+uring_buffer(struct libinput_uring_source *source, uint16_t bid)
+{
+	return source->buffers + bid * URING_BUFFER_SIZE;
+}
+
+static void
+uring_recycle_buffer(struct libinput_uring_source *source, uint16_t bid)
+{
+	io_uring_buf_ring_add(source->buf_ring,
+			      uring_buffer(source, bid),
+			      URING_BUFFER_SIZE,
+			      bid,
+			      io_uring_buf_ring_mask(URING_NBUFFERS),
+			      0);
+	io_uring_buf_ring_advance(source->buf_ring, 1);
+	source->nbuffers_available++;
+}
+
+/* The lowest buffer group id not used by any other source */
+static uint16_t
+uring_find_bgid(struct libinput_uring *uring)
+{
+	struct libinput_uring_source *source;
+	uint16_t bgid = 0;
+	bool in_use;
+
+	do {
+		in_use = false;
+		list_for_each(source, &uring->sources, link) {
+			if (source->buf_ring && source->bgid == bgid) {
+				in_use = true;
+				bgid++;
+				break;
+			}
+		}
+	} while (in_use);
+
+	return bgid;
+}
+
+static bool
+uring_source_setup_buffers(struct libinput_uring_source *source)
+{
+	struct libinput_uring *uring = source->uring;
+	uint16_t bgid = uring_find_bgid(uring);
+	int rc;
+
+	source->buf_ring = io_uring_setup_buf_ring(&uring->ring,
+						   URING_NBUFFERS,
+						   bgid,
+						   0,
+						   &rc);
+	if (!source->buf_ring)
+		return false;
+
+	source->bgid = bgid;
+	source->buffers = zalloc(URING_NBUFFERS * URING_BUFFER_SIZE);
+	for (uint16_t bid = 0; bid < URING_NBUFFERS; bid++)
+		uring_recycle_buffer(source, bid);
+
+	return true;
+}
+
+static void
+uring_source_release_buffers(struct libinput_uring_source *source)
+{
+	if (source->buf_ring)
+		io_uring_free_buf_ring(&source->uring->ring,
+				       source->buf_ring,
+				       URING_NBUFFERS,
+				       source->bgid);
+	source->buf_ring = NULL;
+}
+
+static bool
+uring_source_arm(struct libinput_uring_source *source)
+{
+	struct libinput_uring *uring = source->uring;
+	struct io_uring_sqe *sqe = io_uring_get_sqe(&uring->ring);
+
+	if (!sqe)
+		return false;
+
+	io_uring_prep_read_multishot(sqe, source->fd, 0, 0, source->bgid);
+	io_uring_sqe_set_data(sqe, source);
+	source->armed = true;
+
+	return true;
+}
+
+static void
+uring_source_cancel(struct libinput_uring_source *source)
+{
+	struct libinput_uring *uring = source->uring;
+	struct io_uring_sqe *sqe;
+
+	if (!source->armed || source->cancelling)
+		return;
+
+	sqe = io_uring_get_sqe(&uring->ring);
+	if (!sqe) {
+		/* The submission queue is full, submitting makes room */
+		io_uring_submit(&uring->ring);
+		sqe = io_uring_get_sqe(&uring->ring);
+	}
+	/* Still no room, uring_dispatch() tries again */
+	if (!sqe)
+		return;
+
+	io_uring_prep_cancel(sqe, source, 0);
+	io_uring_sqe_set_data(sqe, NULL);
+	io_uring_submit(&uring->ring);
+	source->cancelling = true;
+}
+
+static void
+uring_source_free(struct libinput_uring_source *source)
+{
+	uring_source_release_buffers(source);
+	list_remove(&source->link);
+	free(source->buffers);
+	free(source);
+}
+
+static void
+uring_handle_cqe(struct libinput_uring *uring, const struct io_uring_cqe *cqe)
+{
+	struct libinput_uring_source *source = io_uring_cqe_get_data(cqe);
+
+	/* Completion of a cancel request */
+	if (!source)
+		return;
+
+	if (cqe->flags & IORING_CQE_F_BUFFER) {
+		uint16_t bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+
+		assert(source->nbuffers_available > 0);
+		source->nbuffers_available--;
+
+		if (source->removed || source->cancelling || cqe->res <= 0) {
+			uring_recycle_buffer(source, bid);
+		} else {
+			uring->libinput->stats.uring_completions++;
+			size_t idx = (source->pending_first + source->npending) %
+				     URING_NBUFFERS;
+			source->pending[idx].bid = bid;
+			source->pending[idx].len = cqe->res;
+			source->npending++;
+		}
+	}
+
+	if (cqe->flags & IORING_CQE_F_MORE)
+		return;
+
+	/* The multishot read terminated, either because we cancelled it,
+	 * because we ran out of buffers (rearmed after dispatching) or
+	 * because of an error */
+	source->armed = false;
+	source->cancelling = false;
+	if (source->removed)
+		return;
+
+	if (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -ECANCELED)
+		source->error = cqe->res;
+}
+
+/* Dispatch all sources with data of the given priority, or all sources
+ * with data if priority is -1 */
+static void
+uring_dispatch_sources(struct libinput_uring *uring, int priority)
+{
+	struct libinput_uring_source *source;
+
+	list_for_each_safe(source, &uring->sources, link) {
+		if (source->removed)
+			continue;
+
+		if (priority != -1 && (int)source->priority != priority)
+			continue;
+
+		if (source->npending > 0 || source->error)
+			source->dispatch(source->user_data);
+	}
+}
+
+static void
+uring_dispatch(void *data)
+{
+	struct libinput_uring *uring = data;
+	struct libinput *libinput = uring->libinput;
+	struct libinput_uring_source *source;
+	struct io_uring_cqe *cqe;
+	unsigned int head, count = 0;
+	eventfd_t value;
+	bool pending = false;
+
+	eventfd_read(uring->eventfd, &value);
+
+	io_uring_for_each_cqe(&uring->ring, head, cqe) {
+		uring_handle_cqe(uring, cqe);
+		count++;
+	}
+	io_uring_cq_advance(&uring->ring, count);
+
+	/* See LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS */
+	if (libinput->dispatch_flags & LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS) {
+		uring_dispatch_sources(uring, LIBINPUT_SOURCE_PRIORITY_HIGH);
+		uring_dispatch_sources(uring, LIBINPUT_SOURCE_PRIORITY_DEFAULT);
+	} else {
+		uring_dispatch_sources(uring, -1);
+	}
+
+	list_for_each_safe(source, &uring->sources, link) {
+		/* Removed sources are only freed here so a dispatch
+		 * callback can remove any source, not just its own */
+		if (source->removed) {
+			if (!source->armed)
+				uring_source_free(source);
+			else
+				uring_source_cancel(source);
+			continue;
+		}
+
+		if (source->paused)
+			uring_source_cancel(source);
+
+		/* Left over because of the dispatch budget, make sure
+		 * we're called again */
+		if (source->npending > 0)
+			pending = true;
+
+		if (!source->armed && !source->paused && !source->error &&
+		    source->nbuffers_available > 0)
+			uring_source_arm(source);
+	}
+
+	io_uring_submit(&uring->ring);
+
+	if (pending)
+		eventfd_write(uring->eventfd, 1);
+}
+
+struct libinput_uring *
+libinput_uring_new(struct libinput *libinput)
+{
+	struct libinput_uring *uring = zalloc(sizeof(*uring));
+	struct io_uring_probe *probe;
+	bool supported;
+	int rc;
+
+	uring->libinput = libinput;
+	uring->eventfd = -1;
+	list_init(&uring->sources);
+
+	rc = io_uring_queue_init(URING_QUEUE_DEPTH, &uring->ring, 0);
+	if (rc < 0) {
+		log_debug(libinput,
+			  "io_uring not available (%s), using epoll\n",
+			  strerror(-rc));
+		free(uring);
+		return NULL;
+	}
+
+	probe = io_uring_get_probe_ring(&uring->ring);
+	supported = probe &&
+		    io_uring_opcode_supported(probe, IORING_OP_READ_MULTISHOT);
+	io_uring_free_probe(probe);
+	if (!supported) {
+		log_debug(libinput,
+			  "io_uring multishot reads not supported, using epoll\n");
+		goto err;
+	}
+
+	uring->eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (uring->eventfd < 0 ||
+	    io_uring_register_eventfd(&uring->ring, uring->eventfd) < 0)
+		goto err;
+
+	uring->source = libinput_add_fd(libinput, uring->eventfd, uring_dispatch, uring);
+	if (!uring->source)
+		goto err;
+
+	log_debug(libinput, "using io_uring to read devices\n");
+
+	return uring;
+
+err:
+	if (uring->eventfd >= 0)
+		close(uring->eventfd);
+	io_uring_queue_exit(&uring->ring);
+	free(uring);
+	return NULL;
+}
+
+void
+libinput_uring_destroy(struct libinput_uring *uring)
+{
+	struct libinput_uring_source *source;
+
+	if (!uring)
+		return;
+
+	libinput_remove_source(uring->libinput, uring->source);
+
+	/* This cancels all outstanding reads, only then may we release
+	 * the buffers they read into. The buffer rings went with the
+	 * io_uring, they just need to be unmapped. */
+	io_uring_queue_exit(&uring->ring);
+	list_for_each_safe(source, &uring->sources, link) {
+		munmap(source->buf_ring, URING_NBUFFERS * sizeof(struct io_uring_buf));
+		source->buf_ring = NULL;
+		uring_source_free(source);
+	}
+
+	close(uring->eventfd);
+	free(uring);
+}
+
+struct libinput_uring_source *
+libinput_uring_add_source(struct libinput_uring *uring,
+			  int fd,
+			  libinput_source_dispatch_t dispatch,
+			  void *data)
+{
+	struct libinput_uring_source *source = zalloc(sizeof(*source));
+
+	source->uring = uring;
+	source->fd = fd;
+	source->dispatch = dispatch;
+	source->user_data = data;
+
+	if (!uring_source_setup_buffers(source)) {
+		free(source);
+		return NULL;
+	}
+	list_append(&uring->sources, &source->link);
+
+	if (!uring_source_arm(source) || io_uring_submit(&uring->ring) < 0) {
+		uring_source_free(source);
+		return NULL;
+	}
+
+	return source;
+}
+
+void
+libinput_uring_remove_source(struct libinput_uring_source *source)
+{
+	libinput_uring_source_flush(source);
+
+	/* Freed once the final completion for the read arrived */
+	source->removed = true;
+	uring_source_cancel(source);
+}
+
+void
+libinput_uring_source_set_priority(struct libinput_uring_source *source,
+				   enum libinput_source_priority priority)
+{
+	source->priority = priority;
+}
+
+void
+libinput_uring_source_flush(struct libinput_uring_source *source)
+{
+	while (source->npending > 0) {
+		uring_recycle_buffer(source, source->pending[source->pending_first].bid);
+		source->pending_first = (source->pending_first + 1) % URING_NBUFFERS;
+		source->npending--;
+	}
+	source->offset = 0;
+}
+
+void
+libinput_uring_source_pause(struct libinput_uring_source *source)
+{
+	libinput_uring_source_flush(source);
+
+	source->paused = true;
+	uring_source_cancel(source);
+}
+
+void
+libinput_uring_source_resume(struct libinput_uring_source *source)
+{
+	struct libinput_uring *uring = source->uring;
+
+	source->paused = false;
+
+	/* If the cancelled read hasn't terminated yet, uring_dispatch()
+	 * re-arms once it did */
+	if (!source->armed && !source->error &&
+	    source->nbuffers_available > 0 && uring_source_arm(source))
+		io_uring_submit(&uring->ring);
+}
+
+ssize_t
+libinput_uring_source_read(struct libinput_uring_source *source,
+			   void *buf,
+			   size_t len)
+{
+	char *dest = buf;
+	size_t nbytes = 0;
+
+	while (nbytes < len && source->npending > 0) {
+		uint16_t bid = source->pending[source->pending_first].bid;
+		size_t avail = source->pending[source->pending_first].len -
+			       source->offset;
+		size_t n = min(avail, len - nbytes);
+
+		memcpy(dest + nbytes,
+		       (char *)uring_buffer(source, bid) + source->offset,
+		       n);
+		nbytes += n;
+		source->offset += n;
+
+		if (n == avail) {
+			uring_recycle_buffer(source, bid);
+			source->pending_first =
+				(source->pending_first + 1) % URING_NBUFFERS;
+			source->npending--;
+			source->offset = 0;
+		}
+	}
+
+	if (nbytes > 0)
+		return nbytes;
+
+	errno = source->error ? -source->error : EAGAIN;
+	return -1;
+}
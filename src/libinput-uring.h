@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "config.h"
+
+#include <errno.h>
+#include <sys/types.h>
+
+#include "libinput-private.h"
+
+struct libinput_uring;
+struct libinput_uring_source;
+
+/**
+ * An io_uring-based alternative to epoll + read() for fds that are
+ * only ever read from (the evdev nodes and the timerfd). A multishot
+ * read is kept outstanding on each fd and the kernel reads into a
+ * per-fd pool of buffers on our behalf. The completions are signalled
+ * through a single eventfd in libinput's epoll set, so many devices
+ * with pending events cost a single wakeup and no read() syscalls.
+ *
+ * Only available if libinput was built with the io-uring option,
+ * otherwise (or if the kernel does not support multishot reads)
+ * libinput_uring_new() returns NULL and the caller falls back to
+ * epoll.
+ */
+#ifdef HAVE_IO_URING
+
+struct libinput_uring *
+libinput_uring_new(struct libinput *libinput);
+
+void
+libinput_uring_destroy(struct libinput_uring *uring);
+
+/**
+ * Start reading from fd. Whenever data is available, dispatch(data) is
+ * called from libinput_dispatch() and should call
+ * libinput_uring_source_read() until it returns less than requested.
+ */
+struct libinput_uring_source *
+libinput_uring_add_source(struct libinput_uring *uring,
+			  int fd,
+			  libinput_source_dispatch_t dispatch,
+			  void *data);
+
+/**
+ * Stop reading from the fd. The source must not be used after this
+ * call, the fd may be closed by the caller.
+ */
+void
+libinput_uring_remove_source(struct libinput_uring_source *source);
+
+void
+libinput_uring_source_set_priority(struct libinput_uring_source *source,
+				   enum libinput_source_priority priority);
+
+/**
+ * Discard all data the kernel has read for us but that has not been
+ * read with libinput_uring_source_read() yet.
+ */
+void
+libinput_uring_source_flush(struct libinput_uring_source *source);
+
+/**
+ * Discard all data the kernel has read for us and stop reading from the
+ * fd until libinput_uring_source_resume(), so the caller can read from
+ * the fd directly (e.g. for a libevdev sync) without io_uring reading
+ * parts of the same data.
+ */
+void
+libinput_uring_source_pause(struct libinput_uring_source *source);
+
+void
+libinput_uring_source_resume(struct libinput_uring_source *source);
+
+/**
+ * Copy up to len bytes of the data the kernel has read for us into
+ * buf.
+ *
+ * @return the number of bytes copied or -1 with errno set, errno is
+ * EAGAIN if no data is available.
+ */
+ssize_t
+libinput_uring_source_read(struct libinput_uring_source *source,
+			   void *buf,
+			   size_t len);
+
+#else
+
+static inline struct libinput_uring *
+libinput_uring_new(struct libinput *libinput)
+{
+	return NULL;
+}
+
+static inline void
+libinput_uring_destroy(struct libinput_uring *uring)
+{
+}
+
+static inline struct libinput_uring_source *
+libinput_uring_add_source(struct libinput_uring *uring,
+			  int fd,
+			  libinput_source_dispatch_t dispatch,
+			  void *data)
+{
+	return NULL;
+}
+
+static inline void
+libinput_uring_remove_source(struct libinput_uring_source *source)
+{
+}
+
+static inline void
+libinput_uring_source_set_priority(struct libinput_uring_source *source,
+				   enum libinput_source_priority priority)
+{
+}
+
+static inline void
+libinput_uring_source_flush(struct libinput_uring_source *source)
+{
+}
+
+static inline void
+libinput_uring_source_pause(struct libinput_uring_source *source)
+{
+}
+
+static inline void
+libinput_uring_source_resume(struct libinput_uring_source *source)
+{
+}
+
+static inline ssize_t
+libinput_uring_source_read(struct libinput_uring_source *source,
+			   void *buf,
+			   size_t len)
+{
+	errno = EAGAIN;
+	return -1;
+}
+
+#endif /* HAVE_IO_URING */
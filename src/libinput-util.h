@@ -32,6 +32,7 @@
 #endif
 
 #include "util-bits.h"
+#include "util-heap.h"
 #include "util-list.h"
 #include "util-macros.h"
 #include "util-matrix.h"
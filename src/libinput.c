@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -40,8 +41,10 @@
 #include "evdev.h"
 #include "libinput-feature.h"
 #include "libinput-private.h"
+#include "libinput-uring.h"
 #include "libinput.h"
 #include "quirks.h"
+#include "reader-thread.h"
 #include "timer.h"
 
 #define require_event_type(li_, type_, retval_, ...)	\
@@ -101,10 +104,12 @@ event_type_to_str(enum libinput_event_type type)
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TOUCH_MOTION);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TOUCH_CANCEL);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TOUCH_FRAME);
+	CASE_RETURN_STRING(LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_TOOL_AXIS);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_TOOL_TIP);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_TOOL_BUTTON);
+	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_PAD_BUTTON);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_PAD_RING);
 	CASE_RETURN_STRING(LIBINPUT_EVENT_TABLET_PAD_STRIP);
@@ -165,6 +170,7 @@ struct libinput_source {
 	libinput_source_dispatch_t dispatch;
 	void *user_data;
 	int fd;
+	enum libinput_source_priority priority;
 	struct list link;
 };
 
@@ -203,6 +209,22 @@ struct libinput_event_touch {
 	struct device_coords point;
 };
 
+/* Max number of touches in one LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME
+ * event, larger frames are split across multiple events */
+#define TOUCH_AGGREGATE_MAX_TOUCHES 32
+
+struct libinput_event_touch_aggregate {
+	struct libinput_event base;
+	usec_t time;
+	unsigned int ntouches;
+	struct touch_aggregate_touch {
+		enum libinput_event_type type;
+		int32_t slot;
+		int32_t seat_slot;
+		struct device_coords point;
+	} touches[TOUCH_AGGREGATE_MAX_TOUCHES];
+};
+
 struct libinput_event_gesture {
 	struct libinput_event base;
 	usec_t time;
@@ -231,6 +253,23 @@ struct libinput_event_tablet_tool {
 	} abs;
 };
 
+/* Max number of samples in one LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH
+ * event, further samples start a new event */
+#define TABLET_TOOL_BATCH_MAX_SAMPLES 32
+
+struct libinput_event_tablet_tool_batch {
+	/* Has the state of the most recent sample, the changed axes are
+	 * those of all samples */
+	struct libinput_event_tablet_tool event;
+	unsigned int nsamples;
+	struct tablet_tool_sample {
+		usec_t time;
+		enum libinput_tablet_tool_tip_state tip_state;
+		struct tablet_axes axes;
+		unsigned char changed_axes[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
+	} samples[TABLET_TOOL_BATCH_MAX_SAMPLES];
+};
+
 struct libinput_event_tablet_pad {
 	struct libinput_event base;
 	unsigned int mode;
@@ -435,6 +474,16 @@ libinput_event_get_touch_event(struct libinput_event *event)
 	return (struct libinput_event_touch *)event;
 }
 
+LIBINPUT_EXPORT struct libinput_event_touch_aggregate *
+libinput_event_get_touch_aggregate_event(struct libinput_event *event)
+{
+	require_event_type(libinput_event_get_context(event),
+			   event->type,
+			   NULL,
+			   LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+	return (struct libinput_event_touch_aggregate *)event;
+}
+
 LIBINPUT_EXPORT struct libinput_event_gesture *
 libinput_event_get_gesture_event(struct libinput_event *event)
 {
@@ -460,6 +509,7 @@ libinput_event_get_tablet_tool_event(struct libinput_event *event)
 			   event->type,
 			   NULL,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON);
@@ -868,6 +918,77 @@ libinput_event_pointer_get_axis_source(struct libinput_event_pointer *event)
 	return event->source;
 }
 
+LIBINPUT_EXPORT size_t
+libinput_event_pointer_get_snapshot(struct libinput_event_pointer *event,
+				    struct libinput_event_pointer_snapshot *snapshot,
+				    size_t size)
+{
+	size_t nbytes = min(size, sizeof(*snapshot));
+
+	memset(snapshot, 0, size);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_POINTER_MOTION,
+			   LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE,
+			   LIBINPUT_EVENT_POINTER_BUTTON,
+			   LIBINPUT_EVENT_POINTER_SCROLL_WHEEL,
+			   LIBINPUT_EVENT_POINTER_SCROLL_FINGER,
+			   LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS,
+			   LIBINPUT_EVENT_POINTER_AXIS);
+
+	struct libinput_event_pointer_snapshot s = {
+		.type = event->base.type,
+		.time_usec = usec_as_uint64_t(event->time),
+	};
+
+	switch (event->base.type) {
+	case LIBINPUT_EVENT_POINTER_MOTION:
+		s.dx = event->delta.x;
+		s.dy = event->delta.y;
+		s.dx_unaccelerated = event->delta_raw.x;
+		s.dy_unaccelerated = event->delta_raw.y;
+		break;
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE: {
+		struct evdev_device *device = evdev_device(event->base.device);
+
+		s.absolute_x = absinfo_convert_to_mm(device->abs.absinfo_x,
+						     event->absolute.x);
+		s.absolute_y = absinfo_convert_to_mm(device->abs.absinfo_y,
+						     event->absolute.y);
+		break;
+	}
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+		s.button = event->button;
+		s.button_state = event->state;
+		s.seat_button_count = event->seat_button_count;
+		break;
+	case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+		s.scroll_v120_vertical = event->v120.y;
+		s.scroll_v120_horizontal = event->v120.x;
+		_fallthrough_;
+	case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+	case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS:
+	case LIBINPUT_EVENT_POINTER_AXIS:
+		s.axes = event->axes;
+		s.axis_source = event->source;
+		s.scroll_vertical = event->delta.y;
+		s.scroll_horizontal = event->delta.x;
+		if (event->base.type == LIBINPUT_EVENT_POINTER_AXIS) {
+			s.scroll_discrete_vertical = event->discrete.y;
+			s.scroll_discrete_horizontal = event->discrete.x;
+		}
+		break;
+	default:
+		break;
+	}
+
+	memcpy(snapshot, &s, nbytes);
+
+	return nbytes;
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_event_touch_get_time(struct libinput_event_touch *event)
 {
@@ -984,6 +1105,165 @@ libinput_event_touch_get_y(struct libinput_event_touch *event)
 	return absinfo_convert_to_mm(device->abs.absinfo_y, event->point.y);
 }
 
+LIBINPUT_EXPORT uint32_t
+libinput_event_touch_aggregate_get_time(struct libinput_event_touch_aggregate *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+
+	return usec_to_millis(event->time);
+}
+
+LIBINPUT_EXPORT uint64_t
+libinput_event_touch_aggregate_get_time_usec(
+	struct libinput_event_touch_aggregate *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+
+	return usec_as_uint64_t(event->time);
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_event_touch_aggregate_get_touch_count(
+	struct libinput_event_touch_aggregate *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+
+	return event->ntouches;
+}
+
+static const struct touch_aggregate_touch *
+touch_aggregate_get_touch(struct libinput_event_touch_aggregate *event,
+			  unsigned int index,
+			  const char *func)
+{
+	struct libinput *libinput = libinput_event_get_context(&event->base);
+
+	if (!check_event_type(libinput,
+			      func,
+			      event->base.type,
+			      LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME,
+			      -1))
+		return NULL;
+
+	if (index >= event->ntouches) {
+		log_bug_client(libinput,
+			       "%s: touch index %u out of range\n",
+			       func,
+			       index);
+		return NULL;
+	}
+
+	return &event->touches[index];
+}
+
+LIBINPUT_EXPORT enum libinput_event_type
+libinput_event_touch_aggregate_get_touch_type(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index)
+{
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	return t ? t->type : LIBINPUT_EVENT_NONE;
+}
+
+LIBINPUT_EXPORT int32_t
+libinput_event_touch_aggregate_get_slot(struct libinput_event_touch_aggregate *event,
+					unsigned int index)
+{
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	return t ? t->slot : 0;
+}
+
+LIBINPUT_EXPORT int32_t
+libinput_event_touch_aggregate_get_seat_slot(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index)
+{
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	return t ? t->seat_slot : 0;
+}
+
+static inline bool
+touch_aggregate_has_point(const struct touch_aggregate_touch *t)
+{
+	return t && (t->type == LIBINPUT_EVENT_TOUCH_DOWN ||
+		     t->type == LIBINPUT_EVENT_TOUCH_MOTION);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_aggregate_get_x(struct libinput_event_touch_aggregate *event,
+				     unsigned int index)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	if (!touch_aggregate_has_point(t))
+		return 0;
+
+	return absinfo_convert_to_mm(device->abs.absinfo_x, t->point.x);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_aggregate_get_y(struct libinput_event_touch_aggregate *event,
+				     unsigned int index)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	if (!touch_aggregate_has_point(t))
+		return 0;
+
+	return absinfo_convert_to_mm(device->abs.absinfo_y, t->point.y);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_aggregate_get_x_transformed(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index,
+	uint32_t width)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	if (!touch_aggregate_has_point(t))
+		return 0;
+
+	return evdev_device_transform_x(device, t->point.x, width);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_aggregate_get_y_transformed(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index,
+	uint32_t height)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct touch_aggregate_touch *t =
+		touch_aggregate_get_touch(event, index, __func__);
+
+	if (!touch_aggregate_has_point(t))
+		return 0;
+
+	return evdev_device_transform_y(device, t->point.y, height);
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_event_gesture_get_time(struct libinput_event_gesture *event)
 {
@@ -1148,6 +1428,7 @@ libinput_event_tablet_tool_x_has_changed(struct libinput_event_tablet_tool *even
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1162,6 +1443,7 @@ libinput_event_tablet_tool_y_has_changed(struct libinput_event_tablet_tool *even
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1177,6 +1459,7 @@ libinput_event_tablet_tool_pressure_has_changed(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1192,6 +1475,7 @@ libinput_event_tablet_tool_distance_has_changed(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1206,6 +1490,7 @@ libinput_event_tablet_tool_tilt_x_has_changed(struct libinput_event_tablet_tool
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1220,6 +1505,7 @@ libinput_event_tablet_tool_tilt_y_has_changed(struct libinput_event_tablet_tool
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1235,6 +1521,7 @@ libinput_event_tablet_tool_rotation_has_changed(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1249,6 +1536,7 @@ libinput_event_tablet_tool_slider_has_changed(struct libinput_event_tablet_tool
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1264,6 +1552,7 @@ libinput_event_tablet_tool_size_major_has_changed(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1279,6 +1568,7 @@ libinput_event_tablet_tool_size_minor_has_changed(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1293,6 +1583,7 @@ libinput_event_tablet_tool_wheel_has_changed(struct libinput_event_tablet_tool *
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1307,6 +1598,7 @@ libinput_event_tablet_tool_get_x(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1321,6 +1613,7 @@ libinput_event_tablet_tool_get_y(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1335,6 +1628,7 @@ libinput_event_tablet_tool_get_dx(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1349,6 +1643,7 @@ libinput_event_tablet_tool_get_dy(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1363,6 +1658,7 @@ libinput_event_tablet_tool_get_pressure(struct libinput_event_tablet_tool *event
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1377,6 +1673,7 @@ libinput_event_tablet_tool_get_distance(struct libinput_event_tablet_tool *event
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1391,6 +1688,7 @@ libinput_event_tablet_tool_get_tilt_x(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1405,6 +1703,7 @@ libinput_event_tablet_tool_get_tilt_y(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1419,6 +1718,7 @@ libinput_event_tablet_tool_get_rotation(struct libinput_event_tablet_tool *event
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1433,6 +1733,7 @@ libinput_event_tablet_tool_get_slider_position(struct libinput_event_tablet_tool
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1447,6 +1748,7 @@ libinput_event_tablet_tool_get_size_major(struct libinput_event_tablet_tool *eve
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1461,6 +1763,7 @@ libinput_event_tablet_tool_get_size_minor(struct libinput_event_tablet_tool *eve
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1475,6 +1778,7 @@ libinput_event_tablet_tool_get_wheel_delta(struct libinput_event_tablet_tool *ev
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1490,6 +1794,7 @@ libinput_event_tablet_tool_get_wheel_delta_discrete(
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1505,6 +1810,7 @@ libinput_event_tablet_tool_get_x_transformed(struct libinput_event_tablet_tool *
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1520,6 +1826,7 @@ libinput_event_tablet_tool_get_y_transformed(struct libinput_event_tablet_tool *
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1534,6 +1841,7 @@ libinput_event_tablet_tool_get_tool(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1548,6 +1856,7 @@ libinput_event_tablet_tool_get_proximity_state(struct libinput_event_tablet_tool
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1562,6 +1871,7 @@ libinput_event_tablet_tool_get_tip_state(struct libinput_event_tablet_tool *even
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1576,6 +1886,7 @@ libinput_event_tablet_tool_get_time(struct libinput_event_tablet_tool *event)
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1590,6 +1901,7 @@ libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *even
 			   event->base.type,
 			   0,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
@@ -1631,6 +1943,159 @@ libinput_event_tablet_tool_get_seat_button_count(
 	return event->seat_button_count;
 }
 
+static void
+tablet_tool_fill_snapshot(const struct libinput_event_tablet_tool *event,
+			  struct libinput_event_tablet_tool_snapshot *s)
+{
+	static const struct {
+		enum libinput_tablet_tool_axis axis;
+		enum libinput_tablet_tool_snapshot_axis flag;
+	} axis_map[] = {
+		{ LIBINPUT_TABLET_TOOL_AXIS_X, LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_X },
+		{ LIBINPUT_TABLET_TOOL_AXIS_Y, LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_Y },
+		{ LIBINPUT_TABLET_TOOL_AXIS_DISTANCE,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_DISTANCE },
+		{ LIBINPUT_TABLET_TOOL_AXIS_PRESSURE,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_PRESSURE },
+		{ LIBINPUT_TABLET_TOOL_AXIS_TILT_X,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_TILT_X },
+		{ LIBINPUT_TABLET_TOOL_AXIS_TILT_Y,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_TILT_Y },
+		{ LIBINPUT_TABLET_TOOL_AXIS_ROTATION_Z,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_ROTATION },
+		{ LIBINPUT_TABLET_TOOL_AXIS_SLIDER,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SLIDER },
+		{ LIBINPUT_TABLET_TOOL_AXIS_REL_WHEEL,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_WHEEL },
+		{ LIBINPUT_TABLET_TOOL_AXIS_SIZE_MAJOR,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SIZE_MAJOR },
+		{ LIBINPUT_TABLET_TOOL_AXIS_SIZE_MINOR,
+		  LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SIZE_MINOR },
+	};
+
+	*s = (struct libinput_event_tablet_tool_snapshot){
+		.type = event->base.type,
+		.time_usec = usec_as_uint64_t(event->time),
+		.tool = event->tool,
+		.proximity_state = event->proximity_state,
+		.tip_state = event->tip_state,
+		.x = absinfo_convert_to_mm(&event->abs.x, event->axes.point.x),
+		.y = absinfo_convert_to_mm(&event->abs.y, event->axes.point.y),
+		.dx = event->axes.delta.x,
+		.dy = event->axes.delta.y,
+		.pressure = event->axes.pressure,
+		.distance = event->axes.distance,
+		.tilt_x = event->axes.tilt.x,
+		.tilt_y = event->axes.tilt.y,
+		.rotation = event->axes.rotation,
+		.slider_position = event->axes.slider,
+		.size_major = event->axes.size.major,
+		.size_minor = event->axes.size.minor,
+		.wheel_delta = event->axes.wheel,
+		.wheel_delta_discrete = event->axes.wheel_discrete,
+	};
+
+	ARRAY_FOR_EACH(axis_map, m) {
+		if (bit_is_set(event->changed_axes, m->axis))
+			s->changed_axes |= m->flag;
+	}
+
+	if (event->base.type == LIBINPUT_EVENT_TABLET_TOOL_BUTTON) {
+		s->button = event->button;
+		s->button_state = event->state;
+		s->seat_button_count = event->seat_button_count;
+	}
+}
+
+LIBINPUT_EXPORT size_t
+libinput_event_tablet_tool_get_snapshot(
+	struct libinput_event_tablet_tool *event,
+	struct libinput_event_tablet_tool_snapshot *snapshot,
+	size_t size)
+{
+	struct libinput_event_tablet_tool_snapshot s;
+	size_t nbytes = min(size, sizeof(*snapshot));
+
+	memset(snapshot, 0, size);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	tablet_tool_fill_snapshot(event, &s);
+	memcpy(snapshot, &s, nbytes);
+
+	return nbytes;
+}
+
+LIBINPUT_EXPORT unsigned int
+libinput_event_tablet_tool_get_sample_count(struct libinput_event_tablet_tool *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	if (event->base.type != LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH)
+		return 1;
+
+	return ((struct libinput_event_tablet_tool_batch *)event)->nsamples;
+}
+
+LIBINPUT_EXPORT size_t
+libinput_event_tablet_tool_get_sample_snapshot(
+	struct libinput_event_tablet_tool *event,
+	unsigned int index,
+	struct libinput_event_tablet_tool_snapshot *snapshot,
+	size_t size)
+{
+	struct libinput_event_tablet_tool_batch *batch;
+	struct libinput_event_tablet_tool sample_event;
+	const struct tablet_tool_sample *sample;
+	struct libinput_event_tablet_tool_snapshot s;
+	size_t nbytes = min(size, sizeof(*snapshot));
+
+	memset(snapshot, 0, size);
+
+	if (index >= libinput_event_tablet_tool_get_sample_count(event)) {
+		log_bug_client(libinput_event_get_context(&event->base),
+			       "%s: sample index %u out of range\n",
+			       __func__,
+			       index);
+		return 0;
+	}
+
+	if (event->base.type != LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH) {
+		tablet_tool_fill_snapshot(event, &s);
+		memcpy(snapshot, &s, nbytes);
+		return nbytes;
+	}
+
+	batch = (struct libinput_event_tablet_tool_batch *)event;
+	sample = &batch->samples[index];
+	sample_event = batch->event;
+	sample_event.time = sample->time;
+	sample_event.tip_state = sample->tip_state;
+	sample_event.axes = sample->axes;
+	memcpy(sample_event.changed_axes,
+	       sample->changed_axes,
+	       sizeof(sample_event.changed_axes));
+
+	tablet_tool_fill_snapshot(&sample_event, &s);
+	memcpy(snapshot, &s, nbytes);
+
+	return nbytes;
+}
+
 LIBINPUT_EXPORT enum libinput_tablet_tool_type
 libinput_tablet_tool_get_type(struct libinput_tablet_tool *tool)
 {
@@ -1851,6 +2316,13 @@ libinput_add_fd(struct libinput *libinput,
 	return source;
 }
 
+void
+libinput_source_set_priority(struct libinput_source *source,
+			     enum libinput_source_priority priority)
+{
+	source->priority = priority;
+}
+
 void
 libinput_remove_source(struct libinput *libinput, struct libinput_source *source)
 {
@@ -1859,6 +2331,16 @@ libinput_remove_source(struct libinput *libinput, struct libinput_source *source
 	list_insert(&libinput->source_destroy_list, &source->link);
 }
 
+static void
+libinput_drop_destroyed_sources(struct libinput *libinput)
+{
+	struct libinput_source *source;
+
+	list_for_each_safe(source, &libinput->source_destroy_list, link)
+		free(source);
+	list_init(&libinput->source_destroy_list);
+}
+
 int
 libinput_init(struct libinput *libinput,
 	      const struct libinput_interface *interface,
@@ -1885,9 +2367,22 @@ libinput_init(struct libinput *libinput,
 	list_init(&libinput->device_group_list);
 	list_init(&libinput->tool_list);
 
+	/* Opt-in only, see libinput_set_event_type_enabled() */
+	libinput_set_event_type_enabled(libinput,
+					LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME,
+					0);
+	libinput_set_event_type_enabled(libinput,
+					LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
+					0);
+
 	libinput_plugin_system_init(&libinput->plugin_system);
 
+	/* Falls back to epoll if NULL */
+	libinput->uring = libinput_uring_new(libinput);
+
 	if (libinput_timer_subsys_init(libinput) != 0) {
+		libinput_uring_destroy(libinput->uring);
+		libinput_drop_destroyed_sources(libinput);
 		free(libinput->events);
 		close(libinput->epoll_fd);
 		return -1;
@@ -1900,6 +2395,7 @@ void
 libinput_init_quirks(struct libinput *libinput)
 {
 	const char *data_path, *override_file = NULL;
+	const char *cache_file;
 	struct quirks_context *quirks;
 
 	if (libinput->quirks_initialized)
@@ -1908,17 +2404,21 @@ libinput_init_quirks(struct libinput *libinput)
 	/* If we fail, we'll fail next time too */
 	libinput->quirks_initialized = true;
 
+	cache_file = getenv("LIBINPUT_QUIRKS_CACHE_FILE");
 	data_path = getenv("LIBINPUT_QUIRKS_DIR");
 	if (!data_path) {
 		data_path = LIBINPUT_QUIRKS_DIR;
 		override_file = LIBINPUT_QUIRKS_OVERRIDE_FILE;
+		if (!cache_file)
+			cache_file = LIBINPUT_QUIRKS_CACHE_FILE;
 	}
 
-	quirks = quirks_init_subsystem(data_path,
-				       override_file,
-				       log_msg_va,
-				       libinput,
-				       QLOG_LIBINPUT_LOGGING);
+	quirks = quirks_init_subsystem_with_cache(data_path,
+						  override_file,
+						  cache_file,
+						  log_msg_va,
+						  libinput,
+						  QLOG_LIBINPUT_LOGGING);
 	if (!quirks) {
 		log_error(libinput,
 			  "Failed to load the device quirks from %s%s%s. "
@@ -1941,14 +2441,7 @@ static void
 libinput_seat_destroy(struct libinput_seat *seat);
 
 static void
-libinput_drop_destroyed_sources(struct libinput *libinput)
-{
-	struct libinput_source *source;
-
-	list_for_each_safe(source, &libinput->source_destroy_list, link)
-		free(source);
-	list_init(&libinput->source_destroy_list);
-}
+libinput_event_pool_destroy(struct libinput *libinput);
 
 LIBINPUT_EXPORT struct libinput *
 libinput_ref(struct libinput *libinput)
@@ -1986,6 +2479,7 @@ libinput_unref(struct libinput *libinput)
 	list_for_each_safe(tool, &libinput->tool_list, link) {
 		libinput_tablet_tool_unref(tool);
 	}
+	free(libinput->tool_index.buckets);
 
 	libinput_plugin_system_destroy(&libinput->plugin_system);
 
@@ -2000,7 +2494,14 @@ libinput_unref(struct libinput *libinput)
 		libinput_device_group_destroy(group);
 	}
 
+	/* Devices may hold on to pooled frames and events, they return
+	 * to the pools when the device is destroyed */
+	evdev_frame_pool_destroy(&libinput->plugin_system.frame_pool);
+	libinput_event_pool_destroy(libinput);
+
+	reader_thread_destroy(libinput->reader);
 	libinput_timer_subsys_destroy(libinput);
+	libinput_uring_destroy(libinput->uring);
 	libinput_drop_destroyed_sources(libinput);
 	quirks_context_unref(libinput->quirks);
 	close(libinput->epoll_fd);
@@ -2013,12 +2514,154 @@ struct quirks *
 libinput_device_get_quirks(struct libinput_device *device)
 {
 	struct libinput *libinput = libinput_device_get_context(device);
+
+	if (device->quirks_fetched)
+		return quirks_ref(device->quirks);
+
 	_unref_(udev_device) *udev_device = libinput_device_get_udev_device(device);
 	if (udev_device)
 		return quirks_fetch_for_device(libinput->quirks, udev_device);
 	return NULL;
 }
 
+static inline enum event_pool_type
+event_pool_type_for(enum libinput_event_type type)
+{
+	switch (type) {
+	case LIBINPUT_EVENT_NONE:
+		abort();
+	case LIBINPUT_EVENT_DEVICE_ADDED:
+	case LIBINPUT_EVENT_DEVICE_REMOVED:
+		return EVENT_POOL_DEVICE_NOTIFY;
+	case LIBINPUT_EVENT_KEYBOARD_KEY:
+		return EVENT_POOL_KEYBOARD;
+	case LIBINPUT_EVENT_POINTER_MOTION:
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+	case LIBINPUT_EVENT_POINTER_BUTTON:
+	case LIBINPUT_EVENT_POINTER_AXIS:
+	case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+	case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+	case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS:
+		return EVENT_POOL_POINTER;
+	case LIBINPUT_EVENT_TOUCH_DOWN:
+	case LIBINPUT_EVENT_TOUCH_UP:
+	case LIBINPUT_EVENT_TOUCH_MOTION:
+	case LIBINPUT_EVENT_TOUCH_CANCEL:
+	case LIBINPUT_EVENT_TOUCH_FRAME:
+		return EVENT_POOL_TOUCH;
+	case LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME:
+		return EVENT_POOL_TOUCH_AGGREGATE;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+	case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
+		return EVENT_POOL_TABLET_TOOL;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
+		return EVENT_POOL_TABLET_TOOL_BATCH;
+	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+	case LIBINPUT_EVENT_TABLET_PAD_RING:
+	case LIBINPUT_EVENT_TABLET_PAD_STRIP:
+	case LIBINPUT_EVENT_TABLET_PAD_KEY:
+	case LIBINPUT_EVENT_TABLET_PAD_DIAL:
+		return EVENT_POOL_TABLET_PAD;
+	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+	case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+	case LIBINPUT_EVENT_GESTURE_PINCH_END:
+	case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN:
+	case LIBINPUT_EVENT_GESTURE_HOLD_END:
+		return EVENT_POOL_GESTURE;
+	case LIBINPUT_EVENT_SWITCH_TOGGLE:
+		return EVENT_POOL_SWITCH;
+	}
+
+	abort();
+}
+
+static usec_t
+libinput_event_get_time(struct libinput_event *event)
+{
+	switch (event_pool_type_for(event->type)) {
+	case EVENT_POOL_DEVICE_NOTIFY:
+		break;
+	case EVENT_POOL_KEYBOARD:
+		return ((struct libinput_event_keyboard *)event)->time;
+	case EVENT_POOL_POINTER:
+		return ((struct libinput_event_pointer *)event)->time;
+	case EVENT_POOL_TOUCH:
+		return ((struct libinput_event_touch *)event)->time;
+	case EVENT_POOL_TOUCH_AGGREGATE:
+		return ((struct libinput_event_touch_aggregate *)event)->time;
+	case EVENT_POOL_GESTURE:
+		return ((struct libinput_event_gesture *)event)->time;
+	case EVENT_POOL_TABLET_TOOL:
+	case EVENT_POOL_TABLET_TOOL_BATCH:
+		return ((struct libinput_event_tablet_tool *)event)->time;
+	case EVENT_POOL_TABLET_PAD:
+		return ((struct libinput_event_tablet_pad *)event)->time;
+	case EVENT_POOL_SWITCH:
+		return ((struct libinput_event_switch *)event)->time;
+	case EVENT_POOL_COUNT:
+		abort();
+	}
+
+	return usec_from_uint64_t(0);
+}
+
+/**
+ * Allocate a zeroed event struct of the given size, re-using a
+ * previously destroyed event of the same struct type where possible.
+ * The type is only used to pick the pool, the caller still has to
+ * initialize the event base.
+ */
+static void *
+libinput_event_zalloc(struct libinput_device *device,
+		      enum libinput_event_type type,
+		      size_t size)
+{
+	struct libinput *libinput = device->seat->libinput;
+	struct libinput_event_pool *pool =
+		&libinput->event_pool[event_pool_type_for(type)];
+	struct libinput_event *event;
+
+	if (pool->count == 0) {
+		libinput->stats.event_pool_misses++;
+		return zalloc(size);
+	}
+
+	libinput->stats.event_pool_hits++;
+	event = pool->events[--pool->count];
+	memset(event, 0, size);
+
+	return event;
+}
+
+static void
+libinput_event_release(struct libinput *libinput, struct libinput_event *event)
+{
+	struct libinput_event_pool *pool =
+		&libinput->event_pool[event_pool_type_for(event->type)];
+
+	if (pool->count >= ARRAY_LENGTH(pool->events)) {
+		free(event);
+		return;
+	}
+
+	pool->events[pool->count++] = event;
+}
+
+static void
+libinput_event_pool_destroy(struct libinput *libinput)
+{
+	ARRAY_FOR_EACH(libinput->event_pool, pool) {
+		for (size_t i = 0; i < pool->count; i++)
+			free(pool->events[i]);
+		pool->count = 0;
+	}
+}
+
 static void
 libinput_event_tablet_tool_destroy(struct libinput_event_tablet_tool *event)
 {
@@ -2032,17 +2675,15 @@ libinput_event_tablet_pad_destroy(struct libinput_event_tablet_pad *event)
 		libinput_tablet_pad_mode_group_unref(event->mode_group);
 }
 
-LIBINPUT_EXPORT void
-libinput_event_destroy(struct libinput_event *event)
+static void
+libinput_event_destroy_payload(struct libinput_event *event)
 {
-	if (event == NULL)
-		return;
-
 	switch (event->type) {
 	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
 	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
 	case LIBINPUT_EVENT_TABLET_TOOL_TIP:
 	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
 		libinput_event_tablet_tool_destroy(
 			libinput_event_get_tablet_tool_event(event));
 		break;
@@ -2057,11 +2698,34 @@ libinput_event_destroy(struct libinput_event *event)
 	default:
 		break;
 	}
+}
 
-	if (event->device)
-		libinput_device_unref(event->device);
+LIBINPUT_EXPORT void
+libinput_event_destroy(struct libinput_event *event)
+{
+	struct libinput *libinput;
 
-	free(event);
+	if (event == NULL)
+		return;
+
+	libinput_event_destroy_payload(event);
+
+	if (event->device == NULL) {
+		free(event);
+		return;
+	}
+
+	/* device may get destroyed by the unref */
+	libinput = libinput_event_get_context(event);
+	libinput_device_unref(event->device);
+	libinput_event_release(libinput, event);
+}
+
+LIBINPUT_EXPORT void
+libinput_events_destroy(struct libinput_event **events, size_t nevents)
+{
+	for (size_t i = 0; i < nevents; i++)
+		libinput_event_destroy(events[i]);
 }
 
 int
@@ -2180,6 +2844,15 @@ static void
 libinput_device_destroy(struct libinput_device *device)
 {
 	assert(list_empty(&device->event_listeners));
+
+	/* Never posted, so it doesn't hold a device ref */
+	if (device->touch_aggregate) {
+		struct libinput_event *event = &device->touch_aggregate->base;
+
+		libinput_event_destroy_payload(event);
+		libinput_event_release(device->seat->libinput, event);
+	}
+
 	evdev_device_destroy(evdev_device(device));
 }
 
@@ -2229,6 +2902,23 @@ libinput_dispatch(struct libinput *libinput)
 	if (count < 0)
 		return -errno;
 
+	/* Stable insertion sort by priority, count is at most 32 and
+	 * usually 1 */
+	if (libinput->dispatch_flags & LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS) {
+		for (i = 1; i < count; ++i) {
+			struct epoll_event e = ep[i];
+			struct libinput_source *s = e.data.ptr;
+			int j = i - 1;
+
+			while (j >= 0 && ((struct libinput_source *)ep[j].data.ptr)
+							 ->priority < s->priority) {
+				ep[j + 1] = ep[j];
+				j--;
+			}
+			ep[j + 1] = e;
+		}
+	}
+
 	for (i = 0; i < count; ++i) {
 		source = ep[i].data.ptr;
 		if (source->fd == -1)
@@ -2341,6 +3031,28 @@ init_event_base(struct libinput_event *event,
 	event->device = device;
 }
 
+static inline bool
+event_type_is_enabled(struct libinput *libinput, enum libinput_event_type type)
+{
+	unsigned int group = type / 100;
+	unsigned int idx = type % 100;
+
+	return !(libinput->disabled_event_types[group] & bit(idx));
+}
+
+/**
+ * Returns true if an event of this type needs to be created. Disabled
+ * event types are still created if the device has internal listeners
+ * (e.g. disable-while-typing), those events are discarded after the
+ * listeners were notified.
+ */
+static inline bool
+event_type_wanted(struct libinput_device *device, enum libinput_event_type type)
+{
+	return event_type_is_enabled(device->seat->libinput, type) ||
+	       !list_empty(&device->event_listeners);
+}
+
 static void
 post_base_event(struct libinput_device *device,
 		enum libinput_event_type type,
@@ -2375,6 +3087,12 @@ post_device_event(struct libinput_device *device,
 	list_for_each_safe(listener, &device->event_listeners, link)
 		listener->notify_func(time, event, listener->notify_func_data);
 
+	if (!event_type_is_enabled(device->seat->libinput, type)) {
+		libinput_event_destroy_payload(event);
+		libinput_event_release(device->seat->libinput, event);
+		return;
+	}
+
 	libinput_post_event(device->seat->libinput, event);
 }
 
@@ -2386,7 +3104,9 @@ notify_added_device(struct libinput_device *device)
 
 	struct libinput_event_device_notify *added_device_event;
 
-	added_device_event = zalloc(sizeof *added_device_event);
+	added_device_event = libinput_event_zalloc(device,
+						   LIBINPUT_EVENT_DEVICE_ADDED,
+						   sizeof *added_device_event);
 
 	post_base_event(device, LIBINPUT_EVENT_DEVICE_ADDED, &added_device_event->base);
 
@@ -2405,7 +3125,9 @@ notify_removed_device(struct libinput_device *device)
 
 	struct libinput_event_device_notify *removed_device_event;
 
-	removed_device_event = zalloc(sizeof *removed_device_event);
+	removed_device_event = libinput_event_zalloc(device,
+						     LIBINPUT_EVENT_DEVICE_REMOVED,
+						     sizeof *removed_device_event);
 
 	post_base_event(device,
 			LIBINPUT_EVENT_DEVICE_REMOVED,
@@ -2470,10 +3192,15 @@ keyboard_notify_key(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_KEYBOARD))
 		return;
 
-	key_event = zalloc(sizeof *key_event);
-
 	seat_key_count = update_seat_key_count(device->seat, keycode, state);
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_KEYBOARD_KEY))
+		return;
+
+	key_event = libinput_event_zalloc(device,
+					  LIBINPUT_EVENT_KEYBOARD_KEY,
+					  sizeof *key_event);
+
 	*key_event = (struct libinput_event_keyboard){
 		.time = time,
 		.key = keycode_as_uint32_t(keycode),
@@ -2495,7 +3222,12 @@ pointer_notify_motion(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	motion_event = zalloc(sizeof *motion_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_MOTION))
+		return;
+
+	motion_event = libinput_event_zalloc(device,
+					     LIBINPUT_EVENT_POINTER_MOTION,
+					     sizeof *motion_event);
 
 	*motion_event = (struct libinput_event_pointer){
 		.time = time,
@@ -2519,7 +3251,12 @@ pointer_notify_motion_absolute(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	motion_absolute_event = zalloc(sizeof *motion_absolute_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE))
+		return;
+
+	motion_absolute_event = libinput_event_zalloc(device,
+						      LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE,
+						      sizeof *motion_absolute_event);
 
 	*motion_absolute_event = (struct libinput_event_pointer){
 		.time = time,
@@ -2544,10 +3281,15 @@ pointer_notify_button(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	button_event = zalloc(sizeof *button_event);
-
 	seat_button_count = update_seat_button_count(device->seat, button, state);
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_BUTTON))
+		return;
+
+	button_event = libinput_event_zalloc(device,
+					     LIBINPUT_EVENT_POINTER_BUTTON,
+					     sizeof *button_event);
+
 	*button_event = (struct libinput_event_pointer){
 		.time = time,
 		.button = button_code_as_uint32_t(button),
@@ -2570,14 +3312,7 @@ pointer_notify_axis_finger(struct libinput_device *device,
 	struct libinput_event_pointer *axis_event, *axis_event_legacy;
 	const struct discrete_coords zero_discrete = { 0 };
 	const struct wheel_v120 zero_v120 = { 0 };
-
-	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
-		return;
-
-	axis_event = zalloc(sizeof *axis_event);
-	axis_event_legacy = zalloc(sizeof *axis_event_legacy);
-
-	*axis_event = (struct libinput_event_pointer){
+	const struct libinput_event_pointer template = {
 		.time = time,
 		.delta = *delta,
 		.source = LIBINPUT_POINTER_AXIS_SOURCE_FINGER,
@@ -2585,16 +3320,31 @@ pointer_notify_axis_finger(struct libinput_device *device,
 		.discrete = zero_discrete,
 		.v120 = zero_v120,
 	};
-	*axis_event_legacy = *axis_event;
 
-	post_device_event(device,
-			  time,
-			  LIBINPUT_EVENT_POINTER_SCROLL_FINGER,
-			  &axis_event->base);
-	post_device_event(device,
-			  time,
-			  LIBINPUT_EVENT_POINTER_AXIS,
-			  &axis_event_legacy->base);
+	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
+		return;
+
+	if (event_type_wanted(device, LIBINPUT_EVENT_POINTER_SCROLL_FINGER)) {
+		axis_event = libinput_event_zalloc(device,
+						   LIBINPUT_EVENT_POINTER_SCROLL_FINGER,
+						   sizeof *axis_event);
+		*axis_event = template;
+		post_device_event(device,
+				  time,
+				  LIBINPUT_EVENT_POINTER_SCROLL_FINGER,
+				  &axis_event->base);
+	}
+
+	if (event_type_wanted(device, LIBINPUT_EVENT_POINTER_AXIS)) {
+		axis_event_legacy = libinput_event_zalloc(device,
+							  LIBINPUT_EVENT_POINTER_AXIS,
+							  sizeof *axis_event_legacy);
+		*axis_event_legacy = template;
+		post_device_event(device,
+				  time,
+				  LIBINPUT_EVENT_POINTER_AXIS,
+				  &axis_event_legacy->base);
+	}
 }
 
 void
@@ -2606,14 +3356,7 @@ pointer_notify_axis_continuous(struct libinput_device *device,
 	struct libinput_event_pointer *axis_event, *axis_event_legacy;
 	const struct discrete_coords zero_discrete = { 0 };
 	const struct wheel_v120 zero_v120 = { 0 };
-
-	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
-		return;
-
-	axis_event = zalloc(sizeof *axis_event);
-	axis_event_legacy = zalloc(sizeof *axis_event_legacy);
-
-	*axis_event = (struct libinput_event_pointer){
+	const struct libinput_event_pointer template = {
 		.time = time,
 		.delta = *delta,
 		.source = LIBINPUT_POINTER_AXIS_SOURCE_CONTINUOUS,
@@ -2621,16 +3364,31 @@ pointer_notify_axis_continuous(struct libinput_device *device,
 		.discrete = zero_discrete,
 		.v120 = zero_v120,
 	};
-	*axis_event_legacy = *axis_event;
 
-	post_device_event(device,
-			  time,
-			  LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS,
-			  &axis_event->base);
-	post_device_event(device,
-			  time,
-			  LIBINPUT_EVENT_POINTER_AXIS,
-			  &axis_event_legacy->base);
+	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
+		return;
+
+	if (event_type_wanted(device, LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS)) {
+		axis_event = libinput_event_zalloc(device,
+						   LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS,
+						   sizeof *axis_event);
+		*axis_event = template;
+		post_device_event(device,
+				  time,
+				  LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS,
+				  &axis_event->base);
+	}
+
+	if (event_type_wanted(device, LIBINPUT_EVENT_POINTER_AXIS)) {
+		axis_event_legacy = libinput_event_zalloc(device,
+							  LIBINPUT_EVENT_POINTER_AXIS,
+							  sizeof *axis_event_legacy);
+		*axis_event_legacy = template;
+		post_device_event(device,
+				  time,
+				  LIBINPUT_EVENT_POINTER_AXIS,
+				  &axis_event_legacy->base);
+	}
 }
 
 void
@@ -2646,7 +3404,12 @@ pointer_notify_axis_legacy_wheel(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	axis_event = zalloc(sizeof *axis_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_AXIS))
+		return;
+
+	axis_event = libinput_event_zalloc(device,
+					   LIBINPUT_EVENT_POINTER_AXIS,
+					   sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_pointer){
 		.time = time,
@@ -2672,7 +3435,12 @@ pointer_notify_axis_wheel(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_POINTER))
 		return;
 
-	axis_event = zalloc(sizeof *axis_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_POINTER_SCROLL_WHEEL))
+		return;
+
+	axis_event = libinput_event_zalloc(device,
+					   LIBINPUT_EVENT_POINTER_SCROLL_WHEEL,
+					   sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_pointer){
 		.time = time,
@@ -2692,6 +3460,61 @@ pointer_notify_axis_wheel(struct libinput_device *device,
 	/* legacy wheel events are sent separately */
 }
 
+static void
+touch_aggregate_post(struct libinput_device *device)
+{
+	struct libinput_event_touch_aggregate *aggregate = device->touch_aggregate;
+
+	if (!aggregate)
+		return;
+
+	device->touch_aggregate = NULL;
+	post_device_event(device,
+			  aggregate->time,
+			  LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME,
+			  &aggregate->base);
+}
+
+static void
+touch_aggregate_append(struct libinput_device *device,
+		       usec_t time,
+		       enum libinput_event_type type,
+		       int32_t slot,
+		       int32_t seat_slot,
+		       const struct device_coords *point)
+{
+	struct libinput *libinput = device->seat->libinput;
+	struct libinput_event_touch_aggregate *aggregate;
+	const struct device_coords zero = { 0, 0 };
+
+	if (!event_type_is_enabled(libinput, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME))
+		return;
+
+	aggregate = device->touch_aggregate;
+	if (aggregate && aggregate->ntouches == ARRAY_LENGTH(aggregate->touches)) {
+		touch_aggregate_post(device);
+		aggregate = NULL;
+	}
+
+	if (!aggregate) {
+		aggregate = libinput_event_zalloc(device,
+						  LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME,
+						  sizeof *aggregate);
+		/* The rest of the base is set when posted, the type is
+		 * needed to release it if it never is */
+		aggregate->base.type = LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME;
+		device->touch_aggregate = aggregate;
+	}
+
+	aggregate->time = time;
+	aggregate->touches[aggregate->ntouches++] = (struct touch_aggregate_touch){
+		.type = type,
+		.slot = slot,
+		.seat_slot = seat_slot,
+		.point = point ? *point : zero,
+	};
+}
+
 void
 touch_notify_touch_down(struct libinput_device *device,
 			usec_t time,
@@ -2704,7 +3527,19 @@ touch_notify_touch_down(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	touch_aggregate_append(device,
+			       time,
+			       LIBINPUT_EVENT_TOUCH_DOWN,
+			       slot,
+			       seat_slot,
+			       point);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_DOWN))
+		return;
+
+	touch_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TOUCH_DOWN,
+					    sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch){
 		.time = time,
@@ -2728,7 +3563,19 @@ touch_notify_touch_motion(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	touch_aggregate_append(device,
+			       time,
+			       LIBINPUT_EVENT_TOUCH_MOTION,
+			       slot,
+			       seat_slot,
+			       point);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_MOTION))
+		return;
+
+	touch_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TOUCH_MOTION,
+					    sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch){
 		.time = time,
@@ -2754,7 +3601,19 @@ touch_notify_touch_up(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	touch_aggregate_append(device,
+			       time,
+			       LIBINPUT_EVENT_TOUCH_UP,
+			       slot,
+			       seat_slot,
+			       NULL);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_UP))
+		return;
+
+	touch_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TOUCH_UP,
+					    sizeof *touch_event);
 
 	*touch_event = (struct libinput_event_touch){
 		.time = time,
@@ -2771,40 +3630,140 @@ touch_notify_touch_cancel(struct libinput_device *device,
 			  int32_t slot,
 			  int32_t seat_slot)
 {
-	struct libinput_event_touch *touch_event;
+	struct libinput_event_touch *touch_event;
+
+	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
+		return;
+
+	touch_aggregate_append(device,
+			       time,
+			       LIBINPUT_EVENT_TOUCH_CANCEL,
+			       slot,
+			       seat_slot,
+			       NULL);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_CANCEL))
+		return;
+
+	touch_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TOUCH_CANCEL,
+					    sizeof *touch_event);
+
+	*touch_event = (struct libinput_event_touch){
+		.time = time,
+		.slot = slot,
+		.seat_slot = seat_slot,
+	};
+
+	post_device_event(device,
+			  time,
+			  LIBINPUT_EVENT_TOUCH_CANCEL,
+			  &touch_event->base);
+}
+
+void
+touch_notify_frame(struct libinput_device *device, usec_t time)
+{
+	struct libinput_event_touch *touch_event;
+
+	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
+		return;
+
+	touch_aggregate_post(device);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TOUCH_FRAME))
+		return;
+
+	touch_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TOUCH_FRAME,
+					    sizeof *touch_event);
+
+	*touch_event = (struct libinput_event_touch){
+		.time = time,
+	};
+
+	post_device_event(device, time, LIBINPUT_EVENT_TOUCH_FRAME, &touch_event->base);
+}
+
+/**
+ * Returns the most recently queued batch event if the next sample for
+ * this device and tool can be appended to it.
+ */
+static struct libinput_event_tablet_tool_batch *
+tablet_batch_queued(struct libinput_device *device, struct libinput_tablet_tool *tool)
+{
+	struct libinput *libinput = device->seat->libinput;
+	struct libinput_event_tablet_tool_batch *batch;
+	struct libinput_event *queued;
+	size_t len = libinput->events_len;
 
-	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
-		return;
+	if (libinput->events_count == 0)
+		return NULL;
 
-	touch_event = zalloc(sizeof *touch_event);
+	queued = libinput->events[(libinput->events_in + len - 1) % len];
+	if (queued->type != LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH ||
+	    queued->device != device)
+		return NULL;
 
-	*touch_event = (struct libinput_event_touch){
-		.time = time,
-		.slot = slot,
-		.seat_slot = seat_slot,
-	};
+	batch = (struct libinput_event_tablet_tool_batch *)queued;
+	if (batch->event.tool != tool ||
+	    batch->nsamples == ARRAY_LENGTH(batch->samples))
+		return NULL;
 
-	post_device_event(device,
-			  time,
-			  LIBINPUT_EVENT_TOUCH_CANCEL,
-			  &touch_event->base);
+	return batch;
 }
 
-void
-touch_notify_frame(struct libinput_device *device, usec_t time)
+static void
+tablet_batch_append(struct libinput_device *device,
+		    usec_t time,
+		    struct libinput_tablet_tool *tool,
+		    enum libinput_tablet_tool_tip_state tip_state,
+		    unsigned char *changed_axes,
+		    const struct tablet_axes *axes,
+		    const struct input_absinfo *x,
+		    const struct input_absinfo *y)
 {
-	struct libinput_event_touch *touch_event;
+	struct libinput *libinput = device->seat->libinput;
+	struct libinput_event_tablet_tool_batch *batch;
+	struct tablet_tool_sample *sample;
+	bool is_new = false;
 
-	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_TOUCH))
+	if (!event_type_is_enabled(libinput, LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH))
 		return;
 
-	touch_event = zalloc(sizeof *touch_event);
+	batch = tablet_batch_queued(device, tool);
+	if (!batch) {
+		batch = libinput_event_zalloc(device,
+					      LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
+					      sizeof *batch);
+		batch->event = (struct libinput_event_tablet_tool){
+			.tool = libinput_tablet_tool_ref(tool),
+			.proximity_state = LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
+			.abs.x = *x,
+			.abs.y = *y,
+		};
+		is_new = true;
+	}
 
-	*touch_event = (struct libinput_event_touch){
+	sample = &batch->samples[batch->nsamples++];
+	*sample = (struct tablet_tool_sample){
 		.time = time,
+		.tip_state = tip_state,
+		.axes = *axes,
 	};
+	memcpy(sample->changed_axes, changed_axes, sizeof(sample->changed_axes));
 
-	post_device_event(device, time, LIBINPUT_EVENT_TOUCH_FRAME, &touch_event->base);
+	batch->event.time = time;
+	batch->event.tip_state = tip_state;
+	batch->event.axes = *axes;
+	for (size_t i = 0; i < ARRAY_LENGTH(batch->event.changed_axes); i++)
+		batch->event.changed_axes[i] |= changed_axes[i];
+
+	if (is_new)
+		post_device_event(device,
+				  time,
+				  LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
+				  &batch->event.base);
 }
 
 void
@@ -2819,7 +3778,14 @@ tablet_notify_axis(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *axis_event;
 
-	axis_event = zalloc(sizeof *axis_event);
+	tablet_batch_append(device, time, tool, tip_state, changed_axes, axes, x, y);
+
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_AXIS))
+		return;
+
+	axis_event = libinput_event_zalloc(device,
+					   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+					   sizeof *axis_event);
 
 	*axis_event = (struct libinput_event_tablet_tool){
 		.time = time,
@@ -2853,7 +3819,12 @@ tablet_notify_proximity(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *proximity_event;
 
-	proximity_event = zalloc(sizeof *proximity_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY))
+		return;
+
+	proximity_event = libinput_event_zalloc(device,
+						LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY,
+						sizeof *proximity_event);
 
 	*proximity_event = (struct libinput_event_tablet_tool){
 		.time = time,
@@ -2886,7 +3857,12 @@ tablet_notify_tip(struct libinput_device *device,
 {
 	struct libinput_event_tablet_tool *tip_event;
 
-	tip_event = zalloc(sizeof *tip_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_TIP))
+		return;
+
+	tip_event = libinput_event_zalloc(device,
+					  LIBINPUT_EVENT_TABLET_TOOL_TIP,
+					  sizeof *tip_event);
 
 	*tip_event = (struct libinput_event_tablet_tool){
 		.time = time,
@@ -2919,10 +3895,15 @@ tablet_notify_button(struct libinput_device *device,
 	struct libinput_event_tablet_tool *button_event;
 	int32_t seat_button_count;
 
-	button_event = zalloc(sizeof *button_event);
-
 	seat_button_count = update_seat_button_count(device->seat, button, state);
 
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_TOOL_BUTTON))
+		return;
+
+	button_event = libinput_event_zalloc(device,
+					     LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+					     sizeof *button_event);
+
 	*button_event = (struct libinput_event_tablet_tool){
 		.time = time,
 		.tool = libinput_tablet_tool_ref(tool),
@@ -2952,7 +3933,12 @@ tablet_pad_notify_button(struct libinput_device *device,
 	struct libinput_event_tablet_pad *button_event;
 	unsigned int mode;
 
-	button_event = zalloc(sizeof *button_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_BUTTON))
+		return;
+
+	button_event = libinput_event_zalloc(device,
+					     LIBINPUT_EVENT_TABLET_PAD_BUTTON,
+					     sizeof *button_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -2980,7 +3966,12 @@ tablet_pad_notify_dial(struct libinput_device *device,
 	struct libinput_event_tablet_pad *dial_event;
 	unsigned int mode;
 
-	dial_event = zalloc(sizeof *dial_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_DIAL))
+		return;
+
+	dial_event = libinput_event_zalloc(device,
+					   LIBINPUT_EVENT_TABLET_PAD_DIAL,
+					   sizeof *dial_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -3009,7 +4000,12 @@ tablet_pad_notify_ring(struct libinput_device *device,
 	struct libinput_event_tablet_pad *ring_event;
 	unsigned int mode;
 
-	ring_event = zalloc(sizeof *ring_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_RING))
+		return;
+
+	ring_event = libinput_event_zalloc(device,
+					   LIBINPUT_EVENT_TABLET_PAD_RING,
+					   sizeof *ring_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -3039,7 +4035,12 @@ tablet_pad_notify_strip(struct libinput_device *device,
 	struct libinput_event_tablet_pad *strip_event;
 	unsigned int mode;
 
-	strip_event = zalloc(sizeof *strip_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_STRIP))
+		return;
+
+	strip_event = libinput_event_zalloc(device,
+					    LIBINPUT_EVENT_TABLET_PAD_STRIP,
+					    sizeof *strip_event);
 
 	mode = libinput_tablet_pad_mode_group_get_mode(group);
 
@@ -3066,7 +4067,12 @@ tablet_pad_notify_key(struct libinput_device *device,
 {
 	struct libinput_event_tablet_pad *key_event;
 
-	key_event = zalloc(sizeof *key_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_TABLET_PAD_KEY))
+		return;
+
+	key_event = libinput_event_zalloc(device,
+					  LIBINPUT_EVENT_TABLET_PAD_KEY,
+					  sizeof *key_event);
 
 	*key_event = (struct libinput_event_tablet_pad){
 		.time = time,
@@ -3096,7 +4102,12 @@ gesture_notify(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_GESTURE))
 		return;
 
-	gesture_event = zalloc(sizeof *gesture_event);
+	if (!event_type_wanted(device, type))
+		return;
+
+	gesture_event = libinput_event_zalloc(device,
+					      type,
+					      sizeof *gesture_event);
 
 	*gesture_event = (struct libinput_event_gesture){
 		.time = time,
@@ -3228,7 +4239,12 @@ switch_notify_toggle(struct libinput_device *device,
 	if (!device_has_cap(device, LIBINPUT_DEVICE_CAP_SWITCH))
 		return;
 
-	switch_event = zalloc(sizeof *switch_event);
+	if (!event_type_wanted(device, LIBINPUT_EVENT_SWITCH_TOGGLE))
+		return;
+
+	switch_event = libinput_event_zalloc(device,
+					     LIBINPUT_EVENT_SWITCH_TOGGLE,
+					     sizeof *switch_event);
 
 	*switch_event = (struct libinput_event_switch){
 		.time = time,
@@ -3260,58 +4276,310 @@ libinput_print_queued_event(struct libinput_event *event)
 	free(event_str);
 }
 
+static int
+libinput_event_queue_resize(struct libinput *libinput, size_t len)
+{
+	struct libinput_event **events;
+	size_t count = libinput->events_count;
+	size_t first = min(count, libinput->events_len - libinput->events_out);
+
+	assert(len >= count);
+
+	events = calloc(len, sizeof(*events));
+	if (!events)
+		return -ENOMEM;
+
+	/* Unwrap the ring buffer so events_out is at index 0 */
+	memcpy(events,
+	       &libinput->events[libinput->events_out],
+	       first * sizeof(*events));
+	memcpy(events + first, libinput->events, (count - first) * sizeof(*events));
+
+	free(libinput->events);
+	libinput->events = events;
+	libinput->events_len = len;
+	libinput->events_out = 0;
+	libinput->events_in = count % len;
+
+	return 0;
+}
+
+static inline bool
+event_is_pointer_motion(struct libinput_event *event)
+{
+	return event->type == LIBINPUT_EVENT_POINTER_MOTION ||
+	       event->type == LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE;
+}
+
+static inline bool
+event_is_pointer_scroll(struct libinput_event *event)
+{
+	switch (event->type) {
+	case LIBINPUT_EVENT_POINTER_AXIS:
+	case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+	case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+	case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline bool
+scroll_event_has_axis_stop(struct libinput_event_pointer *event)
+{
+	if ((event->axes & bit(LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL)) &&
+	    event->delta.y == 0.0)
+		return true;
+
+	if ((event->axes & bit(LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL)) &&
+	    event->delta.x == 0.0)
+		return true;
+
+	return false;
+}
+
+/**
+ * Merge event into the already queued event if possible. Returns true
+ * if the event was merged, in which case the caller must discard the
+ * event.
+ */
+static bool
+libinput_event_coalesce(struct libinput_event *queued, struct libinput_event *event)
+{
+	struct libinput_event_pointer *q, *e;
+
+	if (queued->type != event->type || queued->device != event->device)
+		return false;
+
+	if (!event_is_pointer_motion(event) && !event_is_pointer_scroll(event))
+		return false;
+
+	q = libinput_event_get_pointer_event(queued);
+	e = libinput_event_get_pointer_event(event);
+
+	switch (event->type) {
+	case LIBINPUT_EVENT_POINTER_MOTION:
+		q->delta.x += e->delta.x;
+		q->delta.y += e->delta.y;
+		q->delta_raw.x += e->delta_raw.x;
+		q->delta_raw.y += e->delta_raw.y;
+		break;
+	case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+		q->absolute = e->absolute;
+		break;
+	default:
+		/* Scroll stop events must stay separate so the caller
+		 * sees the end of the scroll sequence */
+		if (q->axes != e->axes || q->source != e->source ||
+		    scroll_event_has_axis_stop(q) || scroll_event_has_axis_stop(e))
+			return false;
+
+		q->delta.x += e->delta.x;
+		q->delta.y += e->delta.y;
+		q->discrete.x += e->discrete.x;
+		q->discrete.y += e->discrete.y;
+		q->v120.x += e->v120.x;
+		q->v120.y += e->v120.y;
+		break;
+	}
+
+	q->time = e->time;
+
+	return true;
+}
+
+static bool
+libinput_event_queue_coalesce(struct libinput *libinput, struct libinput_event *event)
+{
+	size_t len = libinput->events_len;
+	size_t idx;
+	struct libinput_event *queued;
+
+	if (libinput->events_count == 0)
+		return false;
+
+	idx = (libinput->events_in + len - 1) % len;
+	queued = libinput->events[idx];
+
+	/* Scroll events are posted as pairs of the new-style event and the
+	 * legacy LIBINPUT_EVENT_POINTER_AXIS event. Skip over the other
+	 * half of the pair to find the event to merge into, but only if
+	 * the two are twins from the same frame. Otherwise the merged
+	 * event could end up queued before an older event. */
+	if (event_is_pointer_scroll(event) && event_is_pointer_scroll(queued) &&
+	    queued->type != event->type && queued->device == event->device &&
+	    libinput->events_count > 1) {
+		size_t partner_idx = idx;
+		struct libinput_event *partner = queued;
+		usec_t partner_time = libinput_event_get_pointer_event(partner)->time;
+		usec_t event_time = libinput_event_get_pointer_event(event)->time;
+
+		idx = (idx + len - 1) % len;
+		queued = libinput->events[idx];
+
+		if (queued->type != event->type)
+			return false;
+
+		/* The partner is the twin of this event, the merged event
+		 * has the same timestamp as the partner */
+		if (usec_cmp(partner_time, event_time) == 0) {
+			if (!libinput_event_coalesce(queued, event))
+				return false;
+		} else {
+			usec_t queued_time =
+				libinput_event_get_pointer_event(queued)->time;
+
+			/* The partner is the twin of the event we merge
+			 * into, a partial pair stops coalescing */
+			if (usec_cmp(partner_time, queued_time) != 0)
+				return false;
+
+			if (!libinput_event_coalesce(queued, event))
+				return false;
+
+			/* The merged event is now newer than the partner,
+			 * move it behind the partner to keep the queue in
+			 * timestamp order. If this event's twin follows, it
+			 * is merged into the partner. */
+			libinput->events[idx] = partner;
+			libinput->events[partner_idx] = queued;
+		}
+	} else if (!libinput_event_coalesce(queued, event)) {
+		return false;
+	}
+
+	libinput->stats.events_coalesced++;
+
+	return true;
+}
+
+static bool
+libinput_event_queue_drop_oldest_motion(struct libinput *libinput)
+{
+	size_t len = libinput->events_len;
+	size_t out = libinput->events_out;
+
+	for (size_t i = 0; i < libinput->events_count; i++) {
+		size_t idx = (out + i) % len;
+		struct libinput_event *event = libinput->events[idx];
+
+		if (!event_is_pointer_motion(event))
+			continue;
+
+		/* Shift everything older than the dropped event up by one
+		 * so the queue stays contiguous */
+		while (idx != out) {
+			size_t prev = (idx + len - 1) % len;
+			libinput->events[idx] = libinput->events[prev];
+			idx = prev;
+		}
+
+		libinput->events_out = (out + 1) % len;
+		libinput->events_count--;
+		libinput->stats.events_dropped++;
+		libinput_event_destroy(event);
+
+		return true;
+	}
+
+	return false;
+}
+
 static void
 libinput_post_event(struct libinput *libinput, struct libinput_event *event)
 {
-	struct libinput_event **events = libinput->events;
-	size_t events_len = libinput->events_len;
-	size_t events_count = libinput->events_count;
-	size_t move_len;
-	size_t new_out;
-
 #ifdef EVENT_DEBUGGING
 	libinput_print_queued_event(event);
 #endif
 
-	events_count++;
-	if (events_count > events_len) {
-		void *tmp;
-
-		events_len *= 2;
-		tmp = realloc(events, events_len * sizeof *events);
-		if (!tmp) {
-			log_error(libinput,
-				  "Failed to reallocate event ring buffer. "
-				  "Events may be discarded\n");
-			return;
-		}
+	/* A merged event was never queued, so it doesn't hold a device
+	 * ref yet and can be released directly */
+	if (libinput->events_coalesce &&
+	    libinput_event_queue_coalesce(libinput, event)) {
+		libinput_event_release(libinput, event);
+		return;
+	}
 
-		events = tmp;
-
-		if (libinput->events_count > 0 && libinput->events_in == 0) {
-			libinput->events_in = libinput->events_len;
-		} else if (libinput->events_count > 0 &&
-			   libinput->events_out >= libinput->events_in) {
-			move_len = libinput->events_len - libinput->events_out;
-			new_out = events_len - move_len;
-			memmove(events + new_out,
-				events + libinput->events_out,
-				move_len * sizeof *events);
-			libinput->events_out = new_out;
+	if (libinput->events_count == libinput->events_len) {
+		switch (libinput->events_overflow) {
+		case LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW:
+			break;
+		case LIBINPUT_EVENT_QUEUE_OVERFLOW_COALESCE_MOTION:
+			if (event_is_pointer_motion(event) &&
+			    libinput_event_queue_coalesce(libinput, event)) {
+				libinput_event_release(libinput, event);
+				return;
+			}
+			break;
+		case LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION:
+			libinput_event_queue_drop_oldest_motion(libinput);
+			break;
 		}
+	}
 
-		libinput->events = events;
-		libinput->events_len = events_len;
+	/* If the policy couldn't make room we grow the queue, we never
+	 * discard anything but motion events */
+	if (libinput->events_count == libinput->events_len &&
+	    libinput_event_queue_resize(libinput, libinput->events_len * 2) != 0) {
+		log_error(libinput,
+			  "Failed to reallocate event ring buffer. "
+			  "Events may be discarded\n");
+		return;
 	}
 
 	if (event->device)
 		libinput_device_ref(event->device);
 
-	libinput->events_count = events_count;
-	events[libinput->events_in] = event;
+	libinput->events_count++;
+	libinput->stats.events_queued_max =
+		max(libinput->stats.events_queued_max, libinput->events_count);
+	libinput->events[libinput->events_in] = event;
 	libinput->events_in = (libinput->events_in + 1) % libinput->events_len;
 }
 
+LIBINPUT_EXPORT int
+libinput_event_queue_configure(struct libinput *libinput,
+			       size_t capacity,
+			       enum libinput_event_queue_overflow overflow)
+{
+	int rc;
+
+	switch (overflow) {
+	case LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW:
+	case LIBINPUT_EVENT_QUEUE_OVERFLOW_COALESCE_MOTION:
+	case LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (capacity == 0 || capacity < libinput->events_count)
+		return -EINVAL;
+
+	if (capacity != libinput->events_len) {
+		rc = libinput_event_queue_resize(libinput, capacity);
+		if (rc != 0)
+			return rc;
+	}
+
+	libinput->events_overflow = overflow;
+
+	return 0;
+}
+
+static inline void
+libinput_event_note_dequeued(struct libinput_event *event, usec_t now)
+{
+	usec_t time = libinput_event_get_time(event);
+
+	if (usec_is_zero(time) || usec_cmp(time, now) > 0)
+		return;
+
+	latency_histogram_add(&event->device->latency.dequeue,
+			      usec_delta(now, time));
+}
+
 LIBINPUT_EXPORT struct libinput_event *
 libinput_get_event(struct libinput *libinput)
 {
@@ -3324,9 +4592,53 @@ libinput_get_event(struct libinput *libinput)
 	libinput->events_out = (libinput->events_out + 1) % libinput->events_len;
 	libinput->events_count--;
 
+	if (libinput->latency_stats)
+		libinput_event_note_dequeued(event, libinput_now(libinput));
+
 	return event;
 }
 
+LIBINPUT_EXPORT size_t
+libinput_get_events(struct libinput *libinput,
+		    struct libinput_event **events,
+		    enum libinput_event_type *types,
+		    uint64_t *times,
+		    size_t nevents)
+{
+	size_t count = min(nevents, libinput->events_count);
+	size_t first = min(count, libinput->events_len - libinput->events_out);
+
+	if (count == 0)
+		return 0;
+
+	/* The ring buffer may wrap around, copy in two chunks */
+	memcpy(events,
+	       &libinput->events[libinput->events_out],
+	       first * sizeof(*events));
+	memcpy(events + first, libinput->events, (count - first) * sizeof(*events));
+
+	libinput->events_out = (libinput->events_out + count) % libinput->events_len;
+	libinput->events_count -= count;
+
+	if (libinput->latency_stats) {
+		usec_t now = libinput_now(libinput);
+		for (size_t i = 0; i < count; i++)
+			libinput_event_note_dequeued(events[i], now);
+	}
+
+	if (types) {
+		for (size_t i = 0; i < count; i++)
+			types[i] = events[i]->type;
+	}
+
+	if (times) {
+		for (size_t i = 0; i < count; i++)
+			times[i] = usec_as_uint64_t(libinput_event_get_time(events[i]));
+	}
+
+	return count;
+}
+
 LIBINPUT_EXPORT enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput)
 {
@@ -3339,6 +4651,120 @@ libinput_next_event_type(struct libinput *libinput)
 	return event->type;
 }
 
+LIBINPUT_EXPORT size_t
+libinput_get_stats(struct libinput *libinput,
+		   struct libinput_stats *stats,
+		   size_t size)
+{
+	struct libinput_stats all = libinput->stats;
+	size_t nbytes = min(size, sizeof(all));
+
+	if (libinput->reader)
+		reader_thread_add_stats(libinput->reader, &all);
+
+	memset(stats, 0, size);
+	memcpy(stats, &all, nbytes);
+
+	return nbytes;
+}
+
+LIBINPUT_EXPORT size_t
+libinput_device_get_latency_stats(struct libinput_device *device,
+				  struct libinput_latency_stats *stats,
+				  size_t size)
+{
+	size_t nbytes = min(size, sizeof(device->latency));
+
+	memset(stats, 0, size);
+	memcpy(stats, &device->latency, nbytes);
+
+	return nbytes;
+}
+
+LIBINPUT_EXPORT void
+libinput_set_latency_stats_enabled(struct libinput *libinput, int enabled)
+{
+	libinput->latency_stats = !!enabled;
+}
+
+LIBINPUT_EXPORT int
+libinput_get_latency_stats_enabled(struct libinput *libinput)
+{
+	return libinput->latency_stats;
+}
+
+LIBINPUT_EXPORT int
+libinput_dispatch_configure(struct libinput *libinput,
+			    unsigned int budget,
+			    uint32_t flags)
+{
+	if (flags & ~LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS)
+		return -EINVAL;
+
+	libinput->dispatch_budget = budget;
+	libinput->dispatch_flags = flags;
+
+	return 0;
+}
+
+LIBINPUT_EXPORT int
+libinput_enable_reader_thread(struct libinput *libinput)
+{
+	if (libinput->reader)
+		return 0;
+
+	if (!list_empty(&libinput->seat_list))
+		return -EBUSY;
+
+	return reader_thread_new(libinput, &libinput->reader);
+}
+
+LIBINPUT_EXPORT void
+libinput_event_queue_set_coalescing(struct libinput *libinput, int enabled)
+{
+	libinput->events_coalesce = !!enabled;
+}
+
+LIBINPUT_EXPORT int
+libinput_event_queue_get_coalescing(struct libinput *libinput)
+{
+	return libinput->events_coalesce;
+}
+
+LIBINPUT_EXPORT int
+libinput_set_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type,
+				int enabled)
+{
+	unsigned int group = type / 100;
+	unsigned int idx = type % 100;
+
+	if (type == LIBINPUT_EVENT_NONE || event_type_to_str(type) == NULL)
+		return -EINVAL;
+
+	/* We need those to keep track of the devices */
+	if (type == LIBINPUT_EVENT_DEVICE_ADDED ||
+	    type == LIBINPUT_EVENT_DEVICE_REMOVED)
+		return enabled ? 0 : -EINVAL;
+
+	if (enabled)
+		libinput->disabled_event_types[group] &= ~bit(idx);
+	else
+		libinput->disabled_event_types[group] |= bit(idx);
+
+	return 0;
+}
+
+LIBINPUT_EXPORT int
+libinput_get_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type)
+{
+	if (type == LIBINPUT_EVENT_NONE || event_type_to_str(type) == NULL)
+		return 0;
+
+	return event_type_is_enabled(libinput, type);
+}
+
 LIBINPUT_EXPORT void
 libinput_set_user_data(struct libinput *libinput, void *user_data)
 {
@@ -3696,6 +5122,18 @@ libinput_event_touch_get_base_event(struct libinput_event_touch *event)
 	return &event->base;
 }
 
+LIBINPUT_EXPORT struct libinput_event *
+libinput_event_touch_aggregate_get_base_event(
+	struct libinput_event_touch_aggregate *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   NULL,
+			   LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+
+	return &event->base;
+}
+
 LIBINPUT_EXPORT struct libinput_event *
 libinput_event_gesture_get_base_event(struct libinput_event_gesture *event)
 {
@@ -3721,6 +5159,7 @@ libinput_event_tablet_tool_get_base_event(struct libinput_event_tablet_tool *eve
 			   event->base.type,
 			   NULL,
 			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
 			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY,
 			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON);
@@ -5244,12 +6683,61 @@ libinput_tablet_tool_config_eraser_button_get_default_button(
 }
 
 #ifdef HAVE_LIBWACOM
+/* Loading the libwacom database parses every file in the data directory
+ * and is one of the most expensive parts of adding a tablet. The
+ * database is read-only once loaded, so it's shared by all contexts in
+ * this process that use it and destroyed once the last of them lets go
+ * of it. Updated libwacom data files are picked up the next time the
+ * database is loaded.
+ */
+static struct {
+	pthread_mutex_t lock;
+	WacomDeviceDatabase *db;
+	unsigned int users; /* contexts using the db */
+} libwacom_cache = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static WacomDeviceDatabase *
+libwacom_cache_get(struct libinput *li)
+{
+	WacomDeviceDatabase *db;
+
+	pthread_mutex_lock(&libwacom_cache.lock);
+	if (!libwacom_cache.db) {
+		usec_t start = libinput_now(li);
+
+		libwacom_cache.db = libwacom_database_new();
+		if (libwacom_cache.db)
+			log_debug(li,
+				  "libwacom database loaded in %ums\n",
+				  usec_to_millis(usec_delta(libinput_now(li), start)));
+	}
+	db = libwacom_cache.db;
+	if (db)
+		libwacom_cache.users++;
+	pthread_mutex_unlock(&libwacom_cache.lock);
+
+	return db;
+}
+
+static void
+libwacom_cache_put(void)
+{
+	pthread_mutex_lock(&libwacom_cache.lock);
+	assert(libwacom_cache.users >= 1);
+	if (--libwacom_cache.users == 0) {
+		libwacom_database_destroy(libwacom_cache.db);
+		libwacom_cache.db = NULL;
+	}
+	pthread_mutex_unlock(&libwacom_cache.lock);
+}
+
 WacomDeviceDatabase *
 libinput_libwacom_ref(struct libinput *li)
 {
-	WacomDeviceDatabase *db = NULL;
 	if (!li->libwacom.db) {
-		db = libwacom_database_new();
+		WacomDeviceDatabase *db = libwacom_cache_get(li);
 		if (!db) {
 			log_error(li, "Failed to initialize libwacom context\n");
 			return NULL;
@@ -5260,8 +6748,7 @@ libinput_libwacom_ref(struct libinput *li)
 	}
 
 	li->libwacom.refcount++;
-	db = li->libwacom.db;
-	return db;
+	return li->libwacom.db;
 }
 
 void
@@ -5272,9 +6759,10 @@ libinput_libwacom_unref(struct libinput *li)
 
 	assert(li->libwacom.refcount >= 1);
 
+	/* Other contexts may still use the database */
 	if (--li->libwacom.refcount == 0) {
-		libwacom_database_destroy(li->libwacom.db);
 		li->libwacom.db = NULL;
+		libwacom_cache_put();
 	}
 }
 #endif
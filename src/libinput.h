@@ -144,6 +144,17 @@ struct libinput_event_pointer;
  */
 struct libinput_event_touch;
 
+/**
+ * @ingroup event_touch
+ * @struct libinput_event_touch_aggregate
+ *
+ * All touch changes of one frame in a single event. The only valid event
+ * type for this event is @ref LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME.
+ *
+ * @since 1.32
+ */
+struct libinput_event_touch_aggregate;
+
 /**
  * @ingroup event_gesture
  * @struct libinput_event_gesture
@@ -165,8 +176,9 @@ struct libinput_event_gesture;
  * Tablet tool event representing an axis update, button press, or tool
  * update. Valid event types for this event are @ref
  * LIBINPUT_EVENT_TABLET_TOOL_AXIS, @ref LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY,
- * @ref LIBINPUT_EVENT_TABLET_TOOL_TIP, and @ref
- * LIBINPUT_EVENT_TABLET_TOOL_BUTTON.
+ * @ref LIBINPUT_EVENT_TABLET_TOOL_TIP, @ref
+ * LIBINPUT_EVENT_TABLET_TOOL_BUTTON, and @ref
+ * LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH.
  *
  * @since 1.2
  */
@@ -879,6 +891,22 @@ enum libinput_event_type {
 	 * time. This event has no coordinate information attached.
 	 */
 	LIBINPUT_EVENT_TOUCH_FRAME,
+	/**
+	 * All touches that changed within one device sample time, see
+	 * @ref libinput_event_touch_aggregate. This event is sent
+	 * before the @ref LIBINPUT_EVENT_TOUCH_FRAME event of the same
+	 * frame.
+	 *
+	 * This event type is disabled by default and must be enabled with
+	 * libinput_set_event_type_enabled(). Callers that only handle this
+	 * event type should disable the @ref LIBINPUT_EVENT_TOUCH_DOWN, @ref
+	 * LIBINPUT_EVENT_TOUCH_UP, @ref LIBINPUT_EVENT_TOUCH_MOTION, @ref
+	 * LIBINPUT_EVENT_TOUCH_CANCEL and @ref LIBINPUT_EVENT_TOUCH_FRAME
+	 * events.
+	 *
+	 * @since 1.32
+	 */
+	LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME,
 
 	/**
 	 * One or more axes have changed state on a device with the @ref
@@ -970,6 +998,28 @@ enum libinput_event_type {
 	 * @since 1.2
 	 */
 	LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+	/**
+	 * A batch of axis updates on a device with the @ref
+	 * LIBINPUT_DEVICE_CAP_TABLET_TOOL capability. This event is sent
+	 * for the same device state changes as @ref
+	 * LIBINPUT_EVENT_TABLET_TOOL_AXIS. Consecutive axis updates are
+	 * appended to the same event for as long as it is the most recent
+	 * event in the queue, i.e. until the caller retrieves it or another
+	 * event is queued.
+	 *
+	 * The tablet tool getters return the state of the most recent
+	 * sample. The individual samples are available with
+	 * libinput_event_tablet_tool_get_sample_count() and
+	 * libinput_event_tablet_tool_get_sample_snapshot().
+	 *
+	 * This event type is disabled by default and must be enabled with
+	 * libinput_set_event_type_enabled(). Callers that handle this event
+	 * type should disable the @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS
+	 * events.
+	 *
+	 * @since 1.32
+	 */
+	LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH,
 
 	/**
 	 * A button pressed on a device with the @ref
@@ -1061,6 +1111,24 @@ enum libinput_event_type {
 void
 libinput_event_destroy(struct libinput_event *event);
 
+/**
+ * @ingroup event
+ *
+ * Destroy a set of events, see libinput_event_destroy(). This is
+ * equivalent to calling libinput_event_destroy() for each event in the
+ * array, in order.
+ *
+ * @param events An array of events retrieved by libinput_get_events()
+ * or libinput_get_event()
+ * @param nevents The number of events in the array
+ *
+ * @see libinput_get_events
+ *
+ * @since 1.32
+ */
+void
+libinput_events_destroy(struct libinput_event **events, size_t nevents);
+
 /**
  * @ingroup event
  *
@@ -1137,6 +1205,23 @@ libinput_event_get_keyboard_event(struct libinput_event *event);
 struct libinput_event_touch *
 libinput_event_get_touch_event(struct libinput_event *event);
 
+/**
+ * @ingroup event
+ *
+ * Return the aggregated touch event that is this input event. If the
+ * event type is not @ref LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME, this
+ * function returns NULL.
+ *
+ * The inverse of this function is
+ * libinput_event_touch_aggregate_get_base_event().
+ *
+ * @return An aggregated touch event, or NULL for other events
+ *
+ * @since 1.32
+ */
+struct libinput_event_touch_aggregate *
+libinput_event_get_touch_aggregate_event(struct libinput_event *event);
+
 /**
  * @ingroup event
  *
@@ -1757,6 +1842,89 @@ double
 libinput_event_pointer_get_scroll_value_v120(struct libinput_event_pointer *event,
 					     enum libinput_pointer_axis axis);
 
+/**
+ * @ingroup event_pointer
+ * @struct libinput_event_pointer_snapshot
+ *
+ * All data of a pointer event, see libinput_event_pointer_get_snapshot().
+ *
+ * Fields that do not apply to the event type are zero. New fields are
+ * only ever appended to the end of this struct, existing fields are
+ * never removed or reordered.
+ *
+ * @since 1.32
+ */
+struct libinput_event_pointer_snapshot {
+	/** The event type, see libinput_event_get_type() */
+	uint32_t type;
+	/** See libinput_event_pointer_get_time_usec() */
+	uint64_t time_usec;
+	/** See libinput_event_pointer_get_dx() */
+	double dx;
+	/** See libinput_event_pointer_get_dy() */
+	double dy;
+	/** See libinput_event_pointer_get_dx_unaccelerated() */
+	double dx_unaccelerated;
+	/** See libinput_event_pointer_get_dy_unaccelerated() */
+	double dy_unaccelerated;
+	/** See libinput_event_pointer_get_absolute_x() */
+	double absolute_x;
+	/** See libinput_event_pointer_get_absolute_y() */
+	double absolute_y;
+	/** See libinput_event_pointer_get_button() */
+	uint32_t button;
+	/** See libinput_event_pointer_get_button_state() */
+	uint32_t button_state;
+	/** See libinput_event_pointer_get_seat_button_count() */
+	uint32_t seat_button_count;
+	/**
+	 * Bitmask of the axes in this scroll event, bit N is set if
+	 * libinput_event_pointer_has_axis() returns true for axis N
+	 */
+	uint32_t axes;
+	/** The source of a scroll event */
+	uint32_t axis_source;
+	/**
+	 * See libinput_event_pointer_get_scroll_value() and
+	 * libinput_event_pointer_get_axis_value()
+	 */
+	double scroll_vertical;
+	/** See scroll_vertical */
+	double scroll_horizontal;
+	/** See libinput_event_pointer_get_scroll_value_v120() */
+	double scroll_v120_vertical;
+	/** See libinput_event_pointer_get_scroll_value_v120() */
+	double scroll_v120_horizontal;
+	/** See libinput_event_pointer_get_axis_value_discrete() */
+	double scroll_discrete_vertical;
+	/** See libinput_event_pointer_get_axis_value_discrete() */
+	double scroll_discrete_horizontal;
+};
+
+/**
+ * @ingroup event_pointer
+ *
+ * Copy all data of this event into the given snapshot struct. This is
+ * equivalent to calling each of the individual getters for this event's
+ * type but only needs one call per event.
+ *
+ * The size argument allows for callers compiled against an older
+ * version of libinput: at most size bytes are written. If size is
+ * larger than the struct known to this version of libinput, the excess
+ * bytes are zeroed.
+ *
+ * @param event The libinput pointer event
+ * @param snapshot The struct to fill
+ * @param size sizeof(struct libinput_event_pointer_snapshot)
+ * @return The number of bytes filled in
+ *
+ * @since 1.32
+ */
+size_t
+libinput_event_pointer_get_snapshot(struct libinput_event_pointer *event,
+				    struct libinput_event_pointer_snapshot *snapshot,
+				    size_t size);
+
 /**
  * @ingroup event_pointer
  *
@@ -1927,6 +2095,186 @@ libinput_event_touch_get_y_transformed(struct libinput_event_touch *event,
 struct libinput_event *
 libinput_event_touch_get_base_event(struct libinput_event_touch *event);
 
+/**
+ * @ingroup event_touch
+ *
+ * @param event The libinput aggregated touch event
+ * @return The event time for this event
+ *
+ * @since 1.32
+ */
+uint32_t
+libinput_event_touch_aggregate_get_time(struct libinput_event_touch_aggregate *event);
+
+/**
+ * @ingroup event_touch
+ *
+ * @param event The libinput aggregated touch event
+ * @return The event time for this event in microseconds
+ *
+ * @since 1.32
+ */
+uint64_t
+libinput_event_touch_aggregate_get_time_usec(
+	struct libinput_event_touch_aggregate *event);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the number of touches in this event. Each touch is a change
+ * that would otherwise have been sent as a separate @ref
+ * LIBINPUT_EVENT_TOUCH_DOWN, @ref LIBINPUT_EVENT_TOUCH_UP, @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION or @ref LIBINPUT_EVENT_TOUCH_CANCEL event.
+ * Touches are in the order they would have been sent in.
+ *
+ * A frame with a large number of changed touches may be split across
+ * multiple events of this type.
+ *
+ * @param event The libinput aggregated touch event
+ * @return The number of touches in this event
+ *
+ * @since 1.32
+ */
+unsigned int
+libinput_event_touch_aggregate_get_touch_count(
+	struct libinput_event_touch_aggregate *event);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the type of the given touch, one of @ref
+ * LIBINPUT_EVENT_TOUCH_DOWN, @ref LIBINPUT_EVENT_TOUCH_UP, @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION or @ref LIBINPUT_EVENT_TOUCH_CANCEL.
+ *
+ * @note It is an application bug to call this function with an index
+ * equal to or greater than libinput_event_touch_aggregate_get_touch_count().
+ * For an invalid index, this function returns @ref LIBINPUT_EVENT_NONE.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @return The type of the touch
+ *
+ * @since 1.32
+ */
+enum libinput_event_type
+libinput_event_touch_aggregate_get_touch_type(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_slot() for the given touch.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @return The slot of the touch
+ *
+ * @since 1.32
+ */
+int32_t
+libinput_event_touch_aggregate_get_slot(struct libinput_event_touch_aggregate *event,
+					unsigned int index);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_seat_slot() for the given touch.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @return The seat slot of the touch
+ *
+ * @since 1.32
+ */
+int32_t
+libinput_event_touch_aggregate_get_seat_slot(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_x() for the given touch. For touches of
+ * type @ref LIBINPUT_EVENT_TOUCH_UP and @ref LIBINPUT_EVENT_TOUCH_CANCEL
+ * this function returns 0.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @return The current absolute x coordinate in mm
+ *
+ * @since 1.32
+ */
+double
+libinput_event_touch_aggregate_get_x(struct libinput_event_touch_aggregate *event,
+				     unsigned int index);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_y() for the given touch. For touches of
+ * type @ref LIBINPUT_EVENT_TOUCH_UP and @ref LIBINPUT_EVENT_TOUCH_CANCEL
+ * this function returns 0.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @return The current absolute y coordinate in mm
+ *
+ * @since 1.32
+ */
+double
+libinput_event_touch_aggregate_get_y(struct libinput_event_touch_aggregate *event,
+				     unsigned int index);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_x_transformed() for the given touch.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @param width The current output screen width
+ * @return The current absolute x coordinate transformed to screen
+ * coordinates
+ *
+ * @since 1.32
+ */
+double
+libinput_event_touch_aggregate_get_x_transformed(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index,
+	uint32_t width);
+
+/**
+ * @ingroup event_touch
+ *
+ * Like libinput_event_touch_get_y_transformed() for the given touch.
+ *
+ * @param event The libinput aggregated touch event
+ * @param index The index of the touch
+ * @param height The current output screen height
+ * @return The current absolute y coordinate transformed to screen
+ * coordinates
+ *
+ * @since 1.32
+ */
+double
+libinput_event_touch_aggregate_get_y_transformed(
+	struct libinput_event_touch_aggregate *event,
+	unsigned int index,
+	uint32_t height);
+
+/**
+ * @ingroup event_touch
+ *
+ * @return The generic libinput_event of this event
+ *
+ * @since 1.32
+ */
+struct libinput_event *
+libinput_event_touch_aggregate_get_base_event(
+	struct libinput_event_touch_aggregate *event);
+
 /**
  * @defgroup event_gesture Gesture events
  *
@@ -2868,6 +3216,168 @@ libinput_event_tablet_tool_get_time(struct libinput_event_tablet_tool *event);
 uint64_t
 libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *event);
 
+/**
+ * @ingroup event_tablet
+ *
+ * Bits in the changed_axes field of @ref
+ * libinput_event_tablet_tool_snapshot.
+ *
+ * @since 1.32
+ */
+enum libinput_tablet_tool_snapshot_axis {
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_X = (1 << 0),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_Y = (1 << 1),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_DISTANCE = (1 << 2),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_PRESSURE = (1 << 3),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_TILT_X = (1 << 4),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_TILT_Y = (1 << 5),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_ROTATION = (1 << 6),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SLIDER = (1 << 7),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_WHEEL = (1 << 8),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SIZE_MAJOR = (1 << 9),
+	LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_SIZE_MINOR = (1 << 10),
+};
+
+/**
+ * @ingroup event_tablet
+ * @struct libinput_event_tablet_tool_snapshot
+ *
+ * All data of a tablet tool event, see
+ * libinput_event_tablet_tool_get_snapshot().
+ *
+ * Fields that do not apply to the event type are zero. New fields are
+ * only ever appended to the end of this struct, existing fields are
+ * never removed or reordered.
+ *
+ * @since 1.32
+ */
+struct libinput_event_tablet_tool_snapshot {
+	/** The event type, see libinput_event_get_type() */
+	uint32_t type;
+	/** See libinput_event_tablet_tool_get_time_usec() */
+	uint64_t time_usec;
+	/**
+	 * The tool of this event, see libinput_event_tablet_tool_get_tool().
+	 * The tool is not referenced and only valid for the lifetime of
+	 * the event.
+	 */
+	struct libinput_tablet_tool *tool;
+	/** See libinput_event_tablet_tool_get_proximity_state() */
+	uint32_t proximity_state;
+	/** See libinput_event_tablet_tool_get_tip_state() */
+	uint32_t tip_state;
+	/** Bitmask of enum libinput_tablet_tool_snapshot_axis */
+	uint32_t changed_axes;
+	/** See libinput_event_tablet_tool_get_x() */
+	double x;
+	/** See libinput_event_tablet_tool_get_y() */
+	double y;
+	/** See libinput_event_tablet_tool_get_dx() */
+	double dx;
+	/** See libinput_event_tablet_tool_get_dy() */
+	double dy;
+	/** See libinput_event_tablet_tool_get_pressure() */
+	double pressure;
+	/** See libinput_event_tablet_tool_get_distance() */
+	double distance;
+	/** See libinput_event_tablet_tool_get_tilt_x() */
+	double tilt_x;
+	/** See libinput_event_tablet_tool_get_tilt_y() */
+	double tilt_y;
+	/** See libinput_event_tablet_tool_get_rotation() */
+	double rotation;
+	/** See libinput_event_tablet_tool_get_slider_position() */
+	double slider_position;
+	/** See libinput_event_tablet_tool_get_size_major() */
+	double size_major;
+	/** See libinput_event_tablet_tool_get_size_minor() */
+	double size_minor;
+	/** See libinput_event_tablet_tool_get_wheel_delta() */
+	double wheel_delta;
+	/** See libinput_event_tablet_tool_get_wheel_delta_discrete() */
+	int32_t wheel_delta_discrete;
+	/** See libinput_event_tablet_tool_get_button() */
+	uint32_t button;
+	/** See libinput_event_tablet_tool_get_button_state() */
+	uint32_t button_state;
+	/** See libinput_event_tablet_tool_get_seat_button_count() */
+	uint32_t seat_button_count;
+};
+
+/**
+ * @ingroup event_tablet
+ *
+ * Copy all data of this event into the given snapshot struct. This is
+ * equivalent to calling each of the individual getters and
+ * libinput_event_tablet_tool_*_has_changed() functions but only needs
+ * one call per event.
+ *
+ * The size argument allows for callers compiled against an older
+ * version of libinput: at most size bytes are written. If size is
+ * larger than the struct known to this version of libinput, the excess
+ * bytes are zeroed.
+ *
+ * @param event The libinput tablet tool event
+ * @param snapshot The struct to fill
+ * @param size sizeof(struct libinput_event_tablet_tool_snapshot)
+ * @return The number of bytes filled in
+ *
+ * @since 1.32
+ */
+size_t
+libinput_event_tablet_tool_get_snapshot(
+	struct libinput_event_tablet_tool *event,
+	struct libinput_event_tablet_tool_snapshot *snapshot,
+	size_t size);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the number of axis samples in this event. For events of type
+ * @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH this is the number of axis
+ * updates merged into this event, for all other tablet tool events this
+ * function returns 1.
+ *
+ * @param event The libinput tablet tool event
+ * @return The number of samples in this event
+ *
+ * @since 1.32
+ */
+unsigned int
+libinput_event_tablet_tool_get_sample_count(struct libinput_event_tablet_tool *event);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Like libinput_event_tablet_tool_get_snapshot() but for the sample
+ * with the given index, in the order the samples were generated. The
+ * last sample has the same values as the event itself. The
+ * changed_axes field only contains the axes that changed in this
+ * sample.
+ *
+ * For tablet tool events other than @ref
+ * LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH, index 0 is the only valid index
+ * and equivalent to libinput_event_tablet_tool_get_snapshot().
+ *
+ * @note It is an application bug to call this function with an index
+ * equal to or greater than libinput_event_tablet_tool_get_sample_count().
+ * For an invalid index, this function zeroes the snapshot and returns 0.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The index of the sample
+ * @param snapshot The struct to fill
+ * @param size sizeof(struct libinput_event_tablet_tool_snapshot)
+ * @return The number of bytes filled in
+ *
+ * @since 1.32
+ */
+size_t
+libinput_event_tablet_tool_get_sample_snapshot(
+	struct libinput_event_tablet_tool *event,
+	unsigned int index,
+	struct libinput_event_tablet_tool_snapshot *snapshot,
+	size_t size);
+
 /**
  * @ingroup event_tablet
  *
@@ -3681,6 +4191,35 @@ libinput_udev_create_context(const struct libinput_interface *interface,
 int
 libinput_udev_assign_seat(struct libinput *libinput, const char *seat_id);
 
+/**
+ * @ingroup base
+ *
+ * Keep the devices of this context across libinput_suspend() and
+ * libinput_resume() instead of removing and re-adding them.
+ *
+ * With fast resume enabled, libinput_suspend() closes the file
+ * descriptors of all devices but does not send @ref
+ * LIBINPUT_EVENT_DEVICE_REMOVED events, the device objects and their
+ * configuration stay valid. libinput_resume() re-opens each device that
+ * is still present at the same device node and only sends @ref
+ * LIBINPUT_EVENT_DEVICE_REMOVED for devices that went away (or changed)
+ * in the meantime and @ref LIBINPUT_EVENT_DEVICE_ADDED for devices that
+ * are new. Devices with switches are always removed and re-added so the
+ * switch state is re-synced.
+ *
+ * Fast resume is disabled by default.
+ *
+ * @param libinput A libinput context initialized with
+ * libinput_udev_create_context()
+ * @param enable Non-zero to enable fast resume, zero to disable it
+ *
+ * @return 0 on success or -1 if the context is not a udev context
+ *
+ * @since 1.32
+ */
+int
+libinput_udev_set_fast_resume(struct libinput *libinput, int enable);
+
 /**
  * @ingroup base
  *
@@ -3871,6 +4410,83 @@ libinput_get_fd(struct libinput *libinput);
 int
 libinput_dispatch(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Flags to modify the behavior of libinput_dispatch(), see
+ * libinput_dispatch_configure().
+ *
+ * @since 1.32
+ */
+enum libinput_dispatch_flags {
+	LIBINPUT_DISPATCH_FLAG_NONE = 0,
+	/**
+	 * Process devices with keyboard or switch capabilities before all
+	 * other devices with pending events.
+	 */
+	LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS = (1 << 0),
+};
+
+/**
+ * @ingroup base
+ *
+ * Limit the number of input events libinput reads from each device in
+ * one call to libinput_dispatch(). A device with more events pending
+ * than its budget is continued in the next call to libinput_dispatch()
+ * and the fd returned by libinput_get_fd() stays readable until all
+ * devices are drained. This prevents a single device with a high event
+ * rate from delaying the events of other devices.
+ *
+ * A budget that is too low may introduce input lag for callers that
+ * call libinput_dispatch() only once per frame. The number of times a
+ * device exhausted its budget is available in
+ * libinput_stats::dispatch_budget_exhausted.
+ *
+ * By default the budget is unlimited and no flags are set.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param budget The maximum number of input events read per device and
+ * call to libinput_dispatch(), or 0 for no limit
+ * @param flags A bitmask of enum libinput_dispatch_flags
+ *
+ * @return 0 on success or a negative errno on failure
+ * @retval -EINVAL The flags contain an unknown flag
+ *
+ * @since 1.32
+ */
+int
+libinput_dispatch_configure(struct libinput *libinput,
+			    unsigned int budget,
+			    uint32_t flags);
+
+/**
+ * @ingroup base
+ *
+ * Read the devices' event nodes in a separate thread. The thread reads
+ * the kernel's event buffers as soon as events are available and hands
+ * them to libinput_dispatch() in complete frames. This prevents the
+ * kernel buffers from overflowing (and thus SYN_DROPPED) if the caller
+ * is busy, e.g. a compositor waiting for its next repaint.
+ *
+ * All event processing still happens within libinput_dispatch(), in
+ * the caller's thread, and the fd returned by libinput_get_fd() stays
+ * the only fd the caller needs to monitor. libinput does not call any
+ * of the caller's functions from the reader thread.
+ *
+ * The reader thread must be enabled before any devices are added,
+ * i.e. before libinput_udev_assign_seat() or libinput_path_add_device().
+ * It cannot be disabled again and is stopped in libinput_unref().
+ *
+ * @param libinput A previously initialized libinput context
+ *
+ * @return 0 on success or a negative errno on failure
+ * @retval -EBUSY Devices have already been added to this context
+ *
+ * @since 1.32
+ */
+int
+libinput_enable_reader_thread(struct libinput *libinput);
+
 /**
  * @ingroup base
  *
@@ -3899,6 +4515,230 @@ libinput_get_event(struct libinput *libinput);
 enum libinput_event_type
 libinput_next_event_type(struct libinput *libinput);
 
+/**
+ * @ingroup base
+ *
+ * Retrieve up to nevents events from libinput's internal event queue.
+ * This is equivalent to calling libinput_get_event() up to nevents times
+ * but avoids the per-event call overhead for callers that process
+ * events in batches.
+ *
+ * If types is not NULL, the event type of each retrieved event is
+ * stored in the matching index of the types array. If times is not
+ * NULL, the event timestamp in microseconds of each retrieved event is
+ * stored in the matching index of the times array. Events without a
+ * timestamp (e.g. @ref LIBINPUT_EVENT_DEVICE_ADDED) have a timestamp of
+ * zero. Both arrays, if not NULL, must have space for at least nevents
+ * elements.
+ *
+ * After handling the retrieved events, the caller must destroy each of
+ * them with libinput_event_destroy() or all of them with
+ * libinput_events_destroy().
+ *
+ * @code
+ * struct libinput_event *events[64];
+ * size_t nevents;
+ *
+ * while ((nevents = libinput_get_events(li, events, NULL, NULL, 64)) > 0) {
+ *         for (size_t i = 0; i < nevents; i++)
+ *                 handle_event(events[i]);
+ *         libinput_events_destroy(events, nevents);
+ * }
+ * @endcode
+ *
+ * @param libinput A previously initialized libinput context
+ * @param events The array to store the events in
+ * @param types Optional array to store the event types in, may be NULL
+ * @param times Optional array to store the event timestamps in, may be NULL
+ * @param nevents The maximum number of events to retrieve
+ *
+ * @return The number of events retrieved, 0 if no event is available.
+ *
+ * @see libinput_events_destroy
+ *
+ * @since 1.32
+ */
+size_t
+libinput_get_events(struct libinput *libinput,
+		    struct libinput_event **events,
+		    enum libinput_event_type *types,
+		    uint64_t *times,
+		    size_t nevents);
+
+/**
+ * @ingroup base
+ *
+ * The behavior of the event queue when libinput needs to queue an event
+ * but the queue is already at capacity, see
+ * libinput_event_queue_configure().
+ *
+ * libinput never discards events other than pointer motion events. If
+ * the policy cannot make room for a new event, the queue grows.
+ *
+ * @since 1.32
+ */
+enum libinput_event_queue_overflow {
+	/**
+	 * Double the size of the queue. This is the default behavior.
+	 */
+	LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW = 0,
+	/**
+	 * If both the new event and the most recently queued event are
+	 * pointer motion events of the same type from the same device,
+	 * merge the new event into the queued one. The merged event has
+	 * the sum of the relative deltas (or the most recent absolute
+	 * position) and the timestamp of the most recent event.
+	 */
+	LIBINPUT_EVENT_QUEUE_OVERFLOW_COALESCE_MOTION,
+	/**
+	 * Discard the oldest queued @ref LIBINPUT_EVENT_POINTER_MOTION or
+	 * @ref LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE event. The number
+	 * of discarded events is available in
+	 * libinput_stats::events_dropped.
+	 */
+	LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION,
+};
+
+/**
+ * @ingroup base
+ *
+ * Configure the capacity of libinput's internal event queue and the
+ * policy to apply when the queue is full. The queue is resized to the
+ * given capacity immediately and thereafter only grows if the overflow
+ * policy requires it.
+ *
+ * A caller should call this function immediately after creating the
+ * context, i.e. before libinput_udev_assign_seat() or the first call to
+ * libinput_path_add_device(). Calling it later is permitted as long as
+ * the capacity is large enough for the events currently in the queue.
+ *
+ * By default the queue has a small initial capacity and uses @ref
+ * LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param capacity The number of events the queue can hold
+ * @param overflow The policy to apply when the queue is full
+ *
+ * @return 0 on success or a negative errno on failure
+ * @retval -EINVAL The capacity is zero, smaller than the number of
+ * currently queued events, or the policy is invalid
+ * @retval -ENOMEM The queue could not be allocated
+ *
+ * @since 1.32
+ */
+int
+libinput_event_queue_configure(struct libinput *libinput,
+			       size_t capacity,
+			       enum libinput_event_queue_overflow overflow);
+
+/**
+ * @ingroup base
+ *
+ * Enable or disable event coalescing. If enabled, a new event is merged
+ * into an event already in the queue if the queued event has not yet
+ * been retrieved by the caller and:
+ * - both are @ref LIBINPUT_EVENT_POINTER_MOTION events from the same
+ *   device; the merged event has the sum of both (accelerated and
+ *   unaccelerated) deltas, or
+ * - both are @ref LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE events from the
+ *   same device; the merged event has the most recent position, or
+ * - both are scroll events of the same type, axis source and axes from
+ *   the same device; the merged event has the sum of both scroll values.
+ *   Scroll events with a scroll value of zero (i.e. the end of a scroll
+ *   sequence) are never merged.
+ *
+ * Events are only merged with the most recently queued event. Since
+ * scroll events are queued as pairs of a new-style scroll event and a
+ * legacy @ref LIBINPUT_EVENT_POINTER_AXIS event, scroll events are
+ * merged with the most recently queued pair instead. A merged event has
+ * the timestamp of the most recent event.
+ *
+ * Coalescing is intended for callers that cannot keep up with the
+ * event rate of high-frequency devices and do not need the individual
+ * events, e.g. when updating a cursor position once per frame.
+ *
+ * Coalescing is disabled by default.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param enabled Non-zero to enable coalescing, zero to disable it
+ *
+ * @see libinput_event_queue_get_coalescing
+ *
+ * @since 1.32
+ */
+void
+libinput_event_queue_set_coalescing(struct libinput *libinput, int enabled);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return Non-zero if event coalescing is enabled, zero otherwise
+ *
+ * @see libinput_event_queue_set_coalescing
+ *
+ * @since 1.32
+ */
+int
+libinput_event_queue_get_coalescing(struct libinput *libinput);
+
+/**
+ * @ingroup base
+ *
+ * Enable or disable the generation of events of the given type. Events
+ * of a disabled type are never created or queued, they will not be
+ * returned by libinput_get_event() or libinput_get_events().
+ *
+ * This is intended for callers that do not handle some event types. In
+ * particular, callers that handle @ref LIBINPUT_EVENT_POINTER_SCROLL_WHEEL,
+ * @ref LIBINPUT_EVENT_POINTER_SCROLL_FINGER and @ref
+ * LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS should disable the legacy
+ * @ref LIBINPUT_EVENT_POINTER_AXIS events to halve the number of
+ * scroll events.
+ *
+ * Disabling an event type does not change libinput's internal state
+ * handling, e.g. the seat-wide key and button counts still include keys
+ * and buttons of disabled events.
+ *
+ * The @ref LIBINPUT_EVENT_DEVICE_ADDED and @ref
+ * LIBINPUT_EVENT_DEVICE_REMOVED events cannot be disabled.
+ *
+ * All event types except @ref LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME and
+ * @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH are enabled by default.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param type The event type to enable or disable
+ * @param enabled Non-zero to enable the event type, zero to disable it
+ *
+ * @retval 0 Success
+ * @retval -EINVAL The event type is invalid or cannot be disabled
+ *
+ * @see libinput_get_event_type_enabled
+ *
+ * @since 1.32
+ */
+int
+libinput_set_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type,
+				int enabled);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @param type The event type to check
+ * @return Non-zero if events of this type are generated, zero if
+ * the type was disabled with libinput_set_event_type_enabled() or is
+ * not a valid event type
+ *
+ * @see libinput_set_event_type_enabled
+ *
+ * @since 1.32
+ */
+int
+libinput_get_event_type_enabled(struct libinput *libinput,
+				enum libinput_event_type type);
+
 /**
  * @ingroup base
  *
@@ -4071,6 +4911,135 @@ typedef void (*libinput_log_handler)(struct libinput *libinput,
 void
 libinput_log_set_handler(struct libinput *libinput, libinput_log_handler log_handler);
 
+/**
+ * @ingroup base
+ * @struct libinput_stats
+ *
+ * Internal counters of a libinput context, see libinput_get_stats().
+ *
+ * All counters are monotonically increasing from context creation
+ * unless noted otherwise. New fields are only ever appended to the end
+ * of this struct, existing fields are never removed or reordered.
+ *
+ * @since 1.32
+ */
+struct libinput_stats {
+	/**
+	 * The number of events whose allocation was served from the
+	 * context's pool of recycled events.
+	 */
+	uint64_t event_pool_hits;
+	/**
+	 * The number of events that required a new heap allocation
+	 * because no recycled event was available.
+	 */
+	uint64_t event_pool_misses;
+	/**
+	 * The number of events discarded due to
+	 * @ref LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION.
+	 */
+	uint64_t events_dropped;
+	/**
+	 * The number of events merged into an already queued event.
+	 */
+	uint64_t events_coalesced;
+	/**
+	 * The number of timerfd_settime() calls to reprogram the
+	 * context's timer.
+	 */
+	uint64_t timer_syscalls;
+	/**
+	 * The number of timer updates that did not need a
+	 * timerfd_settime() call because the earliest expiry did not
+	 * change.
+	 */
+	uint64_t timer_syscalls_skipped;
+	/**
+	 * The number of read() calls on device nodes that returned
+	 * events.
+	 */
+	uint64_t read_syscalls;
+	/**
+	 * The number of input events read from device nodes. Together
+	 * with read_syscalls this gives the events per syscall.
+	 */
+	uint64_t read_events;
+	/**
+	 * The number of SYN_REPORT-terminated frames read from device
+	 * nodes. Together with read_syscalls this gives the frames per
+	 * syscall.
+	 */
+	uint64_t read_frames;
+	/**
+	 * The number of times a device had more events pending than its
+	 * budget, see libinput_dispatch_configure().
+	 */
+	uint64_t dispatch_budget_exhausted;
+	/**
+	 * The number of io_uring completions that carried data read
+	 * from a device node or the timer. Always zero unless libinput
+	 * was built with io_uring support and the kernel supports it.
+	 */
+	uint64_t uring_completions;
+	/**
+	 * The largest number of events that were queued at the same
+	 * time, i.e. the high-water mark of the event queue.
+	 */
+	uint64_t events_queued_max;
+	/**
+	 * The number of evdev frames passed into the plugin pipeline,
+	 * including frames generated by libinput itself (e.g. after a
+	 * device resync).
+	 */
+	uint64_t frames_processed;
+	/**
+	 * The number of SYN_DROPPED events, i.e. how often the kernel
+	 * discarded events because libinput did not read them fast
+	 * enough.
+	 */
+	uint64_t syn_dropped;
+	/**
+	 * The number of internal timers that expired.
+	 */
+	uint64_t timer_fires;
+	/**
+	 * The number of evdev frames a plugin queued that had to be
+	 * copied because the plugin modified them after queuing.
+	 */
+	uint64_t plugin_frame_copies;
+};
+
+/**
+ * @ingroup base
+ *
+ * Fill in the context's internal counters. These counters are intended
+ * for monitoring and debugging purposes, their exact meaning may
+ * change between libinput versions.
+ *
+ * The caller must pass the size of the struct it was compiled against,
+ * libinput fills in at most that many bytes. Fields not known to this
+ * version of libinput are set to zero. This allows a caller compiled
+ * against a newer libinput to run against an older one and vice
+ * versa.
+ *
+ * @code
+ * struct libinput_stats stats;
+ * libinput_get_stats(li, &stats, sizeof(stats));
+ * @endcode
+ *
+ * @param libinput A previously initialized libinput context
+ * @param stats The struct to fill in
+ * @param size The size of the struct, usually sizeof(struct libinput_stats)
+ *
+ * @return The number of bytes filled in by libinput
+ *
+ * @since 1.32
+ */
+size_t
+libinput_get_stats(struct libinput *libinput,
+		   struct libinput_stats *stats,
+		   size_t size);
+
 /**
  * @defgroup seat Initialization and manipulation of seats
  *
@@ -4469,6 +5438,123 @@ libinput_device_set_seat_logical_name(struct libinput_device *device, const char
 struct udev_device *
 libinput_device_get_udev_device(struct libinput_device *device);
 
+/**
+ * @ingroup device
+ * @struct libinput_latency_histogram
+ *
+ * A log-bucketed histogram of latencies in microseconds, see
+ * libinput_device_get_latency_stats().
+ *
+ * @since 1.32
+ */
+struct libinput_latency_histogram {
+	/** The number of samples */
+	uint64_t count;
+	/** The sum of all samples in µs, sum/count gives the mean */
+	uint64_t sum_us;
+	/** The largest sample in µs */
+	uint64_t max_us;
+	/**
+	 * buckets[0] counts samples of 0µs, buckets[i] counts samples
+	 * of at least 2^(i-1)µs and less than 2^iµs. The last bucket
+	 * also counts all samples larger than that (~4.2s).
+	 */
+	uint64_t buckets[24];
+};
+
+/**
+ * @ingroup device
+ * @struct libinput_latency_stats
+ *
+ * Latency histograms of a device, see
+ * libinput_device_get_latency_stats().
+ *
+ * New fields are only ever appended to the end of this struct.
+ *
+ * @since 1.32
+ */
+struct libinput_latency_stats {
+	/**
+	 * The time between the kernel timestamp of an evdev frame and
+	 * libinput starting to process that frame within
+	 * libinput_dispatch(). High values indicate the caller does not
+	 * call libinput_dispatch() often enough.
+	 */
+	struct libinput_latency_histogram dispatch;
+	/**
+	 * The time libinput spent processing an evdev frame, i.e.
+	 * converting it into zero or more libinput events.
+	 */
+	struct libinput_latency_histogram processing;
+	/**
+	 * The time between the timestamp of an event and the caller
+	 * retrieving it with libinput_get_event() or
+	 * libinput_get_events(). This is the end-to-end latency of the
+	 * event as seen by the caller. Events without a timestamp (e.g.
+	 * @ref LIBINPUT_EVENT_DEVICE_ADDED) are not counted.
+	 */
+	struct libinput_latency_histogram dequeue;
+};
+
+/**
+ * @ingroup device
+ *
+ * Fill in the latency histograms of this device. The histograms are
+ * only collected while enabled with libinput_set_latency_stats_enabled()
+ * and are intended for monitoring and capacity planning.
+ *
+ * Like libinput_get_stats(), the caller must pass the size of the
+ * struct it was compiled against and libinput fills in at most that
+ * many bytes.
+ *
+ * @param device A previously obtained device
+ * @param stats The struct to fill in
+ * @param size The size of the struct, usually sizeof(struct
+ * libinput_latency_stats)
+ *
+ * @return The number of bytes filled in by libinput
+ *
+ * @since 1.32
+ */
+size_t
+libinput_device_get_latency_stats(struct libinput_device *device,
+				  struct libinput_latency_stats *stats,
+				  size_t size);
+
+/**
+ * @ingroup base
+ *
+ * Enable or disable collecting the latency histograms of all devices,
+ * see libinput_device_get_latency_stats(). Collecting them costs
+ * two clock reads per evdev frame and one per call to
+ * libinput_get_event() or libinput_get_events(), so it is disabled by
+ * default. Disabling it keeps the histograms collected so far.
+ *
+ * @param libinput A previously initialized libinput context
+ * @param enabled Non-zero to enable collecting the histograms, zero to
+ * disable it
+ *
+ * @see libinput_get_latency_stats_enabled
+ *
+ * @since 1.32
+ */
+void
+libinput_set_latency_stats_enabled(struct libinput *libinput, int enabled);
+
+/**
+ * @ingroup base
+ *
+ * @param libinput A previously initialized libinput context
+ * @return Non-zero if the latency histograms are collected, zero
+ * otherwise
+ *
+ * @see libinput_set_latency_stats_enabled
+ *
+ * @since 1.32
+ */
+int
+libinput_get_latency_stats_enabled(struct libinput *libinput);
+
 /**
  * @ingroup device
  *
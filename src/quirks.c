@@ -31,15 +31,21 @@
 #undef NDEBUG /* You don't get to disable asserts here */
 #include <assert.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <libgen.h>
 #include <libudev.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #ifdef __FreeBSD__
 #include <kenv.h>
 #endif
 
+#include "util-stringbuf.h"
+
 #include "libinput-util.h"
+#include "libinput-version.h"
 #include "libinput-versionsort.h"
 #include "quirks.h"
 
@@ -163,6 +169,26 @@ struct section {
 	char *name; /* the [Section Name] */
 	struct match match;
 	struct list properties;
+
+	/* Loaded from the cache, the strings point into
+	 * quirks_context.cache_map and aren't ours to free */
+	bool from_cache;
+
+	size_t index;                /* position in quirks_context.sections */
+	struct section *index_next;  /* next section in the same index bucket */
+	uint64_t index_key;          /* see index_key(), if in index.ids */
+};
+
+/**
+ * A trie of the literal prefixes of MatchName globs, i.e. everything up
+ * to the first wildcard character. A device name can only match
+ * sections whose prefix is a prefix of the device name.
+ */
+struct name_trie {
+	char c;
+	struct name_trie *child;
+	struct name_trie *sibling;
+	struct section *sections; /* sections whose prefix ends here */
 };
 
 /**
@@ -195,8 +221,32 @@ struct quirks_context {
 	char *dmi;
 	char *dt;
 
+	/* Identifies the set of data files the sections were loaded
+	 * from, see quirks_cache_key() */
+	uint64_t cache_key;
+
+	/* The cache file the sections were loaded from, if any */
+	void *cache_map;
+	size_t cache_map_size;
+
 	struct list sections;
 
+	/* Lookup indexes for quirks_fetch_for_device(), built once all
+	 * sections are loaded. Every section is in at most one of
+	 * these, sections that can never match on this host (DMI and
+	 * DT are constant) are in none of them. */
+	struct {
+		size_t nsections;
+		struct section *generic;
+		struct section **ids; /* hashed by bus/vendor/product */
+		size_t nid_buckets;
+		struct name_trie *names;
+	} index;
+
+	/* The number of candidates the index returned for the most
+	 * recent quirks_fetch_for_device(), for the test suite */
+	size_t last_ncandidates;
+
 	/* list of quirks handed to libinput, just for bookkeeping */
 	struct list quirks;
 };
@@ -577,14 +627,19 @@ section_destroy(struct section *s)
 {
 	struct property *p;
 
-	free(s->name);
-	free(s->match.name);
-	free(s->match.uniq);
-	free(s->match.dmi);
-	free(s->match.dt);
+	if (!s->from_cache) {
+		free(s->name);
+		free(s->match.name);
+		free(s->match.uniq);
+		free(s->match.dmi);
+		free(s->match.dt);
+	}
 
-	list_for_each_safe(p, &s->properties, link)
+	list_for_each_safe(p, &s->properties, link) {
+		if (s->from_cache && p->type == PT_STRING)
+			p->value.s = NULL;
 		property_cleanup(p);
+	}
 
 	assert(list_empty(&s->properties));
 
@@ -999,8 +1054,46 @@ out:
 	return rc;
 }
 
+static inline uint64_t
+hash_fnv1a(uint64_t hash, const void *data, size_t len)
+{
+	const unsigned char *bytes = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * Add a data file to the cache key, st is NULL if the file doesn't
+ * exist. See quirks_cache_key().
+ */
+static inline uint64_t
+cache_key_add_stat(uint64_t key, const char *name, const struct stat *st)
+{
+	key = hash_fnv1a(key, name, strlen(name) + 1);
+	if (st) {
+		uint64_t values[] = {
+			st->st_ino,
+			st->st_size,
+			st->st_mtim.tv_sec,
+			st->st_mtim.tv_nsec,
+		};
+		key = hash_fnv1a(key, values, sizeof(values));
+	}
+
+	return key;
+}
+
+/**
+ * Parse the file at path and add it to the context's cache key as
+ * keyname.
+ */
 static inline bool
-parse_file(struct quirks_context *ctx, const char *path)
+parse_file(struct quirks_context *ctx, const char *path, const char *keyname)
 {
 	enum state {
 		STATE_SECTION,
@@ -1010,6 +1103,7 @@ parse_file(struct quirks_context *ctx, const char *path)
 		STATE_ANY,
 	};
 	FILE *fp;
+	struct stat st;
 	char line[512];
 	bool rc = false;
 	enum state state = STATE_SECTION;
@@ -1027,13 +1121,21 @@ parse_file(struct quirks_context *ctx, const char *path)
 		 * happen is for the custom override file, all others are
 		 * provided by scandir so they do exist. Short of races we
 		 * don't care about. */
-		if (errno == ENOENT)
+		if (errno == ENOENT) {
+			ctx->cache_key = cache_key_add_stat(ctx->cache_key, keyname, NULL);
 			return true;
+		}
 
 		qlog_error(ctx, "%s: failed to open file\n", path);
 		goto out;
 	}
 
+	/* Before reading, so a file modified while we parse it
+	 * invalidates a cache written from this context */
+	ctx->cache_key = cache_key_add_stat(ctx->cache_key,
+					    keyname,
+					    fstat(fileno(fp), &st) == 0 ? &st : NULL);
+
 	while (fgets(line, sizeof(line), fp)) {
 		char *comment;
 
@@ -1230,7 +1332,7 @@ parse_files(struct quirks_context *ctx,
 
 		snprintf(path, sizeof(path), "%s/%s", data_path, namelist[idx]->d_name);
 
-		if (!parse_file(ctx, path))
+		if (!parse_file(ctx, path, namelist[idx]->d_name))
 			break;
 	}
 
@@ -1241,12 +1343,613 @@ parse_files(struct quirks_context *ctx,
 	return idx == ndev;
 }
 
+static inline char *
+quirks_runtime_dir(void)
+{
+	_autofree_ char *xdg_runtime_dir = safe_strdup(getenv("XDG_RUNTIME_DIR"));
+	if (!xdg_runtime_dir)
+		xdg_runtime_dir = strdup_printf("/run/user/%d", geteuid());
+
+	return strdup_printf("%s/libinput/", xdg_runtime_dir);
+}
+
+/*
+ * The compiled quirks cache is a flat serialization of all sections,
+ * prefixed by a header. The cache is only valid for the exact set of
+ * data files it was compiled from, identified by the cache key. The
+ * file is written and read on the same host, so we use the native
+ * byte order and struct layout.
+ */
+#define QUIRKS_CACHE_MAGIC "LIQUIRKS"
+#define QUIRKS_CACHE_VERSION 2
+
+struct quirks_cache_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t nsections;
+	uint64_t key;
+	uint64_t payload_size;
+	uint64_t payload_hash;
+};
+
+static inline uint64_t
+cache_key_add_file(uint64_t key, const char *name, const char *path)
+{
+	struct stat st;
+
+	return cache_key_add_stat(key, name, stat(path, &st) == 0 ? &st : NULL);
+}
+
+static inline uint64_t
+cache_key_add_dir(uint64_t key, const char *path)
+{
+	struct dirent **namelist;
+	int ndev;
+
+	ndev = scandir(path, &namelist, is_data_file, versionsort);
+	if (ndev <= 0)
+		return key;
+
+	for (int i = 0; i < ndev; i++) {
+		char file[PATH_MAX];
+
+		snprintf(file, sizeof(file), "%s/%s", path, namelist[i]->d_name);
+		key = cache_key_add_file(key, namelist[i]->d_name, file);
+		free(namelist[i]);
+	}
+	free(namelist);
+
+	return key;
+}
+
+static inline uint64_t
+quirks_cache_key_start(const char *data_path)
+{
+	uint64_t key = 0xcbf29ce484222325ULL;
+	const uint32_t layout[] = {
+		QUIRKS_CACHE_VERSION,
+		sizeof(struct match),
+		sizeof(((struct property *)NULL)->value),
+	};
+
+	key = hash_fnv1a(key, LIBINPUT_VERSION, strlen(LIBINPUT_VERSION));
+	key = hash_fnv1a(key, layout, sizeof(layout));
+	key = hash_fnv1a(key, data_path, strlen(data_path) + 1);
+
+	return key;
+}
+
+static inline uint64_t
+quirks_cache_key_runtime(uint64_t key)
+{
+	return hash_fnv1a(key, "runtime", sizeof("runtime"));
+}
+
+/**
+ * Returns a key that changes whenever one of the data files is added,
+ * removed or modified.
+ *
+ * This needs a stat() of every data file, so it's only used to check
+ * an existing cache file. When parsing the data files, parse_file()
+ * builds the same key from the files it opens.
+ *
+ * The runtime directory differs per user but usually has no data
+ * files, so only the files in it affect the key, not its path. This
+ * way a cache compiled by root is valid for other users too.
+ */
+static uint64_t
+quirks_cache_key(const char *data_path,
+		 const char *override_file,
+		 const char *runtime_dir)
+{
+	uint64_t key = quirks_cache_key_start(data_path);
+
+	key = cache_key_add_dir(key, data_path);
+	if (override_file)
+		key = cache_key_add_file(key, override_file, override_file);
+	key = quirks_cache_key_runtime(key);
+	key = cache_key_add_dir(key, runtime_dir);
+
+	return key;
+}
+
+static inline int
+cache_write(struct stringbuf *b, const void *data, size_t len)
+{
+	int rc = stringbuf_ensure_space(b, len);
+	if (rc < 0)
+		return rc;
+
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+
+	return 0;
+}
+
+static inline int
+cache_write_u32(struct stringbuf *b, uint32_t value)
+{
+	return cache_write(b, &value, sizeof(value));
+}
+
+/* Strings are null-terminated so they can be used in place, see
+ * cache_read_string() */
+static inline int
+cache_write_string(struct stringbuf *b, const char *str)
+{
+	uint32_t len = str ? strlen(str) : UINT32_MAX;
+	int rc = cache_write_u32(b, len);
+
+	if (rc == 0 && str)
+		rc = cache_write(b, str, len + 1);
+
+	return rc;
+}
+
+static int
+cache_write_section(struct stringbuf *b, struct section *s)
+{
+	struct property *p;
+	uint32_t nproperties = 0;
+	uint32_t nproducts = 0;
+	int rc = 0;
+
+	list_for_each(p, &s->properties, link)
+		nproperties++;
+	while (s->match.product[nproducts] != 0)
+		nproducts++;
+
+	rc |= cache_write_string(b, s->name);
+	rc |= cache_write_u32(b, s->match.bits);
+	rc |= cache_write_string(b, s->match.name);
+	rc |= cache_write_string(b, s->match.uniq);
+	rc |= cache_write_u32(b, s->match.bus);
+	rc |= cache_write_u32(b, s->match.vendor);
+	rc |= cache_write_u32(b, nproducts);
+	rc |= cache_write(b, s->match.product, nproducts * sizeof(uint32_t));
+	rc |= cache_write_u32(b, s->match.version);
+	rc |= cache_write_string(b, s->match.dmi);
+	rc |= cache_write_u32(b, s->match.udev_type);
+	rc |= cache_write_string(b, s->match.dt);
+	rc |= cache_write_u32(b, nproperties);
+
+	list_for_each(p, &s->properties, link) {
+		rc |= cache_write_u32(b, p->id);
+		rc |= cache_write_u32(b, p->type);
+		if (p->type == PT_STRING)
+			rc |= cache_write_string(b, p->value.s);
+		else
+			rc |= cache_write(b, &p->value, sizeof(p->value));
+	}
+
+	return rc ? -ENOMEM : 0;
+}
+
+int
+quirks_context_write_cache(struct quirks_context *ctx, const char *path)
+{
+	struct quirks_cache_header header = {
+		.version = QUIRKS_CACHE_VERSION,
+		.key = ctx->cache_key,
+	};
+	_destroy_(stringbuf) *b = stringbuf_new();
+	struct section *s;
+	int rc;
+
+	list_for_each(s, &ctx->sections, link) {
+		rc = cache_write_section(b, s);
+		if (rc < 0)
+			return rc;
+		header.nsections++;
+	}
+
+	memcpy(header.magic, QUIRKS_CACHE_MAGIC, sizeof(header.magic));
+	header.payload_size = b->len;
+	header.payload_hash = hash_fnv1a(0xcbf29ce484222325ULL, b->data, b->len);
+
+	/* Write to a temporary file first so a concurrent reader never
+	 * sees a partially written cache */
+	_autofree_ char *tmppath = strdup_printf("%s.XXXXXX", path);
+	int fd = mkstemp(tmppath);
+	if (fd < 0)
+		return -errno;
+
+	if (fchmod(fd, 0644) < 0 ||
+	    write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header) ||
+	    write(fd, b->data, b->len) != (ssize_t)b->len) {
+		rc = errno ? -errno : -EIO;
+		close(fd);
+		unlink(tmppath);
+		return rc;
+	}
+
+	close(fd);
+	if (rename(tmppath, path) < 0) {
+		rc = -errno;
+		unlink(tmppath);
+		return rc;
+	}
+
+	qlog_debug(ctx, "%s: wrote %u sections\n", path, header.nsections);
+
+	return 0;
+}
+
+struct cache_reader {
+	const unsigned char *data;
+	size_t len;
+	size_t pos;
+};
+
+static inline bool
+cache_read(struct cache_reader *r, void *out, size_t len)
+{
+	if (len > r->len - r->pos)
+		return false;
+
+	memcpy(out, r->data + r->pos, len);
+	r->pos += len;
+
+	return true;
+}
+
+static inline bool
+cache_read_u32(struct cache_reader *r, uint32_t *value)
+{
+	return cache_read(r, value, sizeof(*value));
+}
+
+static inline bool
+cache_read_string(struct cache_reader *r, char **str)
+{
+	uint32_t len;
+
+	*str = NULL;
+
+	if (!cache_read_u32(r, &len))
+		return false;
+
+	if (len == UINT32_MAX)
+		return true;
+
+	if (len >= r->len - r->pos || r->data[r->pos + len] != '\0')
+		return false;
+
+	/* The cache stays mapped for the lifetime of the context */
+	*str = (char *)r->data + r->pos;
+	r->pos += len + 1;
+
+	return true;
+}
+
+static struct section *
+cache_read_section(struct cache_reader *r)
+{
+	struct section *s = zalloc(sizeof(*s));
+	uint32_t bus, udev_type, nproducts, nproperties;
+	bool success = true;
+
+	list_init(&s->link);
+	list_init(&s->properties);
+	s->has_match = true;
+	s->has_property = true;
+	s->from_cache = true;
+
+	success = cache_read_string(r, &s->name) &&
+		  cache_read_u32(r, &s->match.bits) &&
+		  cache_read_string(r, &s->match.name) &&
+		  cache_read_string(r, &s->match.uniq) &&
+		  cache_read_u32(r, &bus) &&
+		  cache_read_u32(r, &s->match.vendor) &&
+		  cache_read_u32(r, &nproducts) &&
+		  nproducts < ARRAY_LENGTH(s->match.product) &&
+		  cache_read(r, s->match.product, nproducts * sizeof(uint32_t)) &&
+		  cache_read_u32(r, &s->match.version) &&
+		  cache_read_string(r, &s->match.dmi) &&
+		  cache_read_u32(r, &udev_type) &&
+		  cache_read_string(r, &s->match.dt) &&
+		  cache_read_u32(r, &nproperties);
+	if (!success || !s->name || (s->match.bits & ~(M_LAST * 2 - 1)))
+		goto error;
+
+	s->match.bus = bus;
+	s->match.udev_type = udev_type;
+
+	for (uint32_t i = 0; i < nproperties; i++) {
+		struct property *p = property_new();
+		uint32_t id, type;
+
+		list_append(&s->properties, &p->link);
+
+		if (!cache_read_u32(r, &id) || !cache_read_u32(r, &type) ||
+		    type > PT_UINT_ARRAY)
+			goto error;
+
+		p->id = id;
+		p->type = type;
+		if (p->type == PT_STRING)
+			success = cache_read_string(r, &p->value.s) && p->value.s;
+		else
+			success = cache_read(r, &p->value, sizeof(p->value));
+		if (!success)
+			goto error;
+	}
+
+	return s;
+
+error:
+	section_destroy(s);
+	return NULL;
+}
+
+/**
+ * Load the sections from the compiled cache file, if that file is valid
+ * for the given data files. On success the file stays mapped until the
+ * context is destroyed, the sections' strings point into it.
+ *
+ * @return true if the sections were loaded, false otherwise
+ */
+static bool
+quirks_load_cache(struct quirks_context *ctx,
+		  const char *path,
+		  const char *data_path,
+		  const char *override_file,
+		  const char *runtime_dir)
+{
+	struct quirks_cache_header header;
+	struct cache_reader reader;
+	struct stat st;
+	struct list sections;
+	struct section *s;
+	void *map;
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(header)) {
+		close(fd);
+		return false;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return false;
+
+	memcpy(&header, map, sizeof(header));
+	if (memcmp(header.magic, QUIRKS_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != QUIRKS_CACHE_VERSION ||
+	    header.payload_size != (size_t)st.st_size - sizeof(header)) {
+		qlog_debug(ctx, "%s: invalid cache file\n", path);
+		goto out;
+	}
+
+	ctx->cache_key = quirks_cache_key(data_path, override_file, runtime_dir);
+	if (header.key != ctx->cache_key) {
+		qlog_debug(ctx, "%s: cache is out of date\n", path);
+		goto out;
+	}
+
+	reader = (struct cache_reader){
+		.data = (const unsigned char *)map + sizeof(header),
+		.len = header.payload_size,
+	};
+
+	if (hash_fnv1a(0xcbf29ce484222325ULL, reader.data, reader.len) !=
+	    header.payload_hash) {
+		qlog_debug(ctx, "%s: cache checksum mismatch\n", path);
+		goto out;
+	}
+
+	list_init(&sections);
+	for (uint32_t i = 0; i < header.nsections; i++) {
+		s = cache_read_section(&reader);
+		if (!s)
+			break;
+		list_append(&sections, &s->link);
+	}
+
+	if (reader.pos != reader.len || list_length(&sections) != header.nsections) {
+		qlog_error(ctx, "%s: corrupt cache file\n", path);
+		list_for_each_safe(s, &sections, link)
+			section_destroy(s);
+		goto out;
+	}
+
+	list_chain(&ctx->sections, &sections);
+	qlog_debug(ctx, "%s: loaded %u sections from cache\n", path, header.nsections);
+
+	/* quirks_context_write_cache() replaces the file with rename(),
+	 * so the file we mapped never changes underneath us */
+	ctx->cache_map = map;
+	ctx->cache_map_size = st.st_size;
+
+	return true;
+out:
+	munmap(map, st.st_size);
+	return false;
+}
+
+static void
+name_trie_destroy(struct name_trie *node)
+{
+	while (node) {
+		struct name_trie *next = node->sibling;
+
+		name_trie_destroy(node->child);
+		free(node);
+		node = next;
+	}
+}
+
+static void
+name_trie_insert(struct name_trie **root,
+		 const char *prefix,
+		 size_t len,
+		 struct section *s)
+{
+	struct name_trie **level = root;
+	struct name_trie *node = NULL;
+
+	for (size_t i = 0; i < len; i++) {
+		node = *level;
+		while (node && node->c != prefix[i])
+			node = node->sibling;
+
+		if (!node) {
+			node = zalloc(sizeof(*node));
+			node->c = prefix[i];
+			node->sibling = *level;
+			*level = node;
+		}
+		level = &node->child;
+	}
+
+	assert(node);
+	s->index_next = node->sections;
+	node->sections = s;
+}
+
+static inline size_t
+glob_prefix_length(const char *pattern)
+{
+	return strcspn(pattern, "*?[\\");
+}
+
+static inline bool
+section_matches_host(struct quirks_context *ctx, struct section *s)
+{
+	if (s->match.bits & M_DMI) {
+		if (!ctx->dmi || fnmatch(s->match.dmi, ctx->dmi, 0) != 0)
+			return false;
+	}
+
+	if (s->match.bits & M_DT) {
+		if (!ctx->dt || fnmatch(s->match.dt, ctx->dt, 0) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * The key of a section in index.ids, made up of the section's
+ * MatchVendor and whichever of MatchBus and MatchProduct it has (as
+ * given in bits). A device is looked up with all four combinations.
+ * Different matches may share a key, that's fine, the candidates get a
+ * full match anyway.
+ */
+static inline uint64_t
+index_key(uint32_t bits, enum bustype bus, uint32_t vendor, uint32_t product)
+{
+	uint64_t key = (uint64_t)(vendor & 0xffff) << 32;
+
+	if (bits & M_BUS)
+		key |= (uint64_t)M_BUS << 56 | (uint64_t)(bus & 0xff) << 48;
+	if (bits & M_PID)
+		key |= (uint64_t)M_PID << 56 | product;
+
+	return key;
+}
+
+static inline size_t
+index_bucket(struct quirks_context *ctx, uint64_t key)
+{
+	return ((key * 0x9E3779B97F4A7C15ULL) >> 32) & (ctx->index.nid_buckets - 1);
+}
+
+static void
+quirks_build_index(struct quirks_context *ctx)
+{
+	struct section *s;
+	size_t nbuckets = 1;
+	size_t idx = 0;
+
+	list_for_each(s, &ctx->sections, link)
+		s->index = idx++;
+	ctx->index.nsections = idx;
+
+	while (nbuckets < ctx->index.nsections)
+		nbuckets <<= 1;
+	ctx->index.nid_buckets = nbuckets;
+	ctx->index.ids = zalloc(nbuckets * sizeof(*ctx->index.ids));
+
+	/* Bucket order doesn't matter, quirks_fetch_for_device() sorts
+	 * the candidates by section index */
+	list_for_each(s, &ctx->sections, link) {
+		size_t prefix_len = 0;
+
+		/* DMI and DT are constant per boot, so sections
+		 * that don't match here never match any device */
+		if (!section_matches_host(ctx, s))
+			continue;
+
+		if (s->match.bits & M_NAME)
+			prefix_len = glob_prefix_length(s->match.name);
+
+		if (s->match.bits & M_VID) {
+			uint32_t bits = s->match.bits & M_BUS;
+			uint32_t product = 0;
+
+			/* A section with a list of products is only
+			 * keyed on the bus and vendor */
+			if ((s->match.bits & M_PID) && s->match.product[1] == 0) {
+				bits |= M_PID;
+				product = s->match.product[0];
+			}
+
+			s->index_key = index_key(bits,
+						 s->match.bus,
+						 s->match.vendor,
+						 product);
+			size_t bucket = index_bucket(ctx, s->index_key);
+			s->index_next = ctx->index.ids[bucket];
+			ctx->index.ids[bucket] = s;
+		} else if (prefix_len > 0) {
+			name_trie_insert(&ctx->index.names,
+					 s->match.name,
+					 prefix_len,
+					 s);
+		} else {
+			s->index_next = ctx->index.generic;
+			ctx->index.generic = s;
+		}
+	}
+}
+
+static void
+quirks_destroy_index(struct quirks_context *ctx)
+{
+	name_trie_destroy(ctx->index.names);
+	free(ctx->index.ids);
+	ctx->index.names = NULL;
+	ctx->index.ids = NULL;
+	ctx->index.generic = NULL;
+}
+
 struct quirks_context *
 quirks_init_subsystem(const char *data_path,
 		      const char *override_file,
 		      libinput_log_handler log_handler,
 		      struct libinput *libinput,
 		      enum quirks_log_type log_type)
+{
+	return quirks_init_subsystem_with_cache(data_path,
+						override_file,
+						NULL,
+						log_handler,
+						libinput,
+						log_type);
+}
+
+struct quirks_context *
+quirks_init_subsystem_with_cache(const char *data_path,
+				 const char *override_file,
+				 const char *cache_file,
+				 libinput_log_handler log_handler,
+				 struct libinput *libinput,
+				 enum quirks_log_type log_type)
 {
 	_unref_(quirks_context) *ctx = zalloc(sizeof *ctx);
 
@@ -1266,20 +1969,29 @@ quirks_init_subsystem(const char *data_path,
 	if (!ctx->dmi && !ctx->dt)
 		return NULL;
 
-	if (!parse_files(ctx, data_path, false))
-		return NULL;
+	_autofree_ char *xdg_runtime_quirks_dir = quirks_runtime_dir();
 
-	if (override_file && !parse_file(ctx, override_file))
-		return NULL;
+	if (!cache_file || !quirks_load_cache(ctx,
+					      cache_file,
+					      data_path,
+					      override_file,
+					      xdg_runtime_quirks_dir)) {
+		/* parse_file() adds each file to the key, the same way
+		 * quirks_cache_key() does */
+		ctx->cache_key = quirks_cache_key_start(data_path);
 
-	_autofree_ char *xdg_runtime_dir = safe_strdup(getenv("XDG_RUNTIME_DIR"));
-	if (!xdg_runtime_dir)
-		xdg_runtime_dir = strdup_printf("/run/user/%d", geteuid());
+		if (!parse_files(ctx, data_path, false))
+			return NULL;
 
-	_autofree_ char *xdg_runtime_quirks_dir =
-		strdup_printf("%s/libinput/", xdg_runtime_dir);
-	if (!parse_files(ctx, xdg_runtime_quirks_dir, true))
-		return NULL;
+		if (override_file && !parse_file(ctx, override_file, override_file))
+			return NULL;
+
+		ctx->cache_key = quirks_cache_key_runtime(ctx->cache_key);
+		if (!parse_files(ctx, xdg_runtime_quirks_dir, true))
+			return NULL;
+	}
+
+	quirks_build_index(ctx);
 
 	return steal(&ctx);
 }
@@ -1293,6 +2005,15 @@ quirks_context_ref(struct quirks_context *ctx)
 	return ctx;
 }
 
+void
+quirks_context_get_match_stats(struct quirks_context *ctx,
+			       size_t *nsections,
+			       size_t *ncandidates)
+{
+	*nsections = ctx->index.nsections;
+	*ncandidates = ctx->last_ncandidates;
+}
+
 struct quirks_context *
 quirks_context_unref(struct quirks_context *ctx)
 {
@@ -1310,10 +2031,15 @@ quirks_context_unref(struct quirks_context *ctx)
 	/* Caller needs to clean up before calling this */
 	assert(list_empty(&ctx->quirks));
 
+	quirks_destroy_index(ctx);
+
 	list_for_each_safe(s, &ctx->sections, link) {
 		section_destroy(s);
 	}
 
+	if (ctx->cache_map)
+		munmap(ctx->cache_map, ctx->cache_map_size);
+
 	free(ctx->dmi);
 	free(ctx->dt);
 	free(ctx);
@@ -1335,15 +2061,26 @@ quirks_new(void)
 	return q;
 }
 
+struct quirks *
+quirks_ref(struct quirks *q)
+{
+	if (q) {
+		assert(q->refcount >= 1);
+		q->refcount++;
+	}
+
+	return q;
+}
+
 struct quirks *
 quirks_unref(struct quirks *q)
 {
 	if (!q)
 		return NULL;
 
-	/* We don't really refcount, but might
-	 * as well have the API in place */
-	assert(q->refcount == 1);
+	assert(q->refcount >= 1);
+	if (--q->refcount > 0)
+		return NULL;
 
 	for (size_t i = 0; i < q->nproperties; i++) {
 		property_unref(q->properties[i]);
@@ -1715,6 +2452,56 @@ quirk_match_section(struct quirks_context *ctx,
 	return true;
 }
 
+static int
+section_index_cmp(const void *a, const void *b)
+{
+	const struct section *sa = *(const struct section **)a;
+	const struct section *sb = *(const struct section **)b;
+
+	return (sa->index > sb->index) - (sa->index < sb->index);
+}
+
+/**
+ * The sections collected by quirks_fetch_for_device(), there are
+ * usually only a few so we start with the array on the stack.
+ */
+struct candidates {
+	struct section **sections;
+	size_t count;
+	size_t size;
+	struct section *stack[32];
+};
+
+static inline void
+candidates_init(struct candidates *c)
+{
+	c->sections = c->stack;
+	c->count = 0;
+	c->size = ARRAY_LENGTH(c->stack);
+}
+
+static inline void
+candidates_fini(struct candidates *c)
+{
+	if (c->sections != c->stack)
+		free(c->sections);
+}
+
+static inline void
+candidates_append(struct candidates *c, struct section *s)
+{
+	if (c->count == c->size) {
+		struct section **sections = zalloc(c->size * 2 * sizeof(*sections));
+
+		memcpy(sections, c->sections, c->count * sizeof(*sections));
+		candidates_fini(c);
+		c->sections = sections;
+		c->size *= 2;
+	}
+
+	c->sections[c->count++] = s;
+}
+
 struct quirks *
 quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *udev_device)
 {
@@ -1726,11 +2513,66 @@ quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *udev_dev
 	_unref_(quirks) *q = quirks_new();
 	_free_(match) *m = match_new(udev_device, ctx->dmi, ctx->dt);
 
+	/* Collect the candidate sections from the index, they still
+	 * need the full match below */
+	struct candidates candidates;
 	struct section *s;
-	list_for_each(s, &ctx->sections, link) {
-		quirk_match_section(ctx, q, s, m, udev_device);
+
+	candidates_init(&candidates);
+
+	for (s = ctx->index.generic; s; s = s->index_next)
+		candidates_append(&candidates, s);
+
+	if (m->bits & M_VID) {
+		const uint32_t keys[] = { 0, M_BUS, M_PID, M_BUS | M_PID };
+
+		ARRAY_FOR_EACH(keys, bits) {
+			if ((m->bits & *bits) != *bits)
+				continue;
+
+			uint64_t key =
+				index_key(*bits, m->bus, m->vendor, m->product[0]);
+			size_t bucket = index_bucket(ctx, key);
+
+			for (s = ctx->index.ids[bucket]; s; s = s->index_next) {
+				if (s->index_key == key)
+					candidates_append(&candidates, s);
+			}
+		}
+	}
+
+	if (m->bits & M_NAME) {
+		struct name_trie *node = ctx->index.names;
+
+		for (const char *c = m->name; *c && node; c++) {
+			while (node && node->c != *c)
+				node = node->sibling;
+			if (!node)
+				break;
+
+			for (s = node->sections; s; s = s->index_next)
+				candidates_append(&candidates, s);
+			node = node->child;
+		}
 	}
 
+	/* Later sections override earlier ones, so we must apply them in
+	 * the order they were loaded */
+	qsort(candidates.sections,
+	      candidates.count,
+	      sizeof(*candidates.sections),
+	      section_index_cmp);
+
+	qlog_debug(ctx,
+		   "%zu of %zu sections are candidates\n",
+		   candidates.count,
+		   ctx->index.nsections);
+	ctx->last_ncandidates = candidates.count;
+
+	for (size_t i = 0; i < candidates.count; i++)
+		quirk_match_section(ctx, q, candidates.sections[i], m, udev_device);
+	candidates_fini(&candidates);
+
 	if (q->nproperties == 0) {
 		return NULL;
 	}
@@ -174,6 +174,33 @@ quirks_init_subsystem(const char *data_path,
 		      struct libinput *libinput,
 		      enum quirks_log_type log_type);
 
+/**
+ * Like quirks_init_subsystem() but load the sections from the compiled
+ * cache file written by quirks_context_write_cache() if that cache
+ * is up-to-date with the data files. Otherwise, or if cache_file is
+ * NULL, the data files are parsed as usual.
+ *
+ * @param cache_file The path to the compiled cache file, may be NULL
+ */
+struct quirks_context *
+quirks_init_subsystem_with_cache(const char *data_path,
+				 const char *override_file,
+				 const char *cache_file,
+				 libinput_log_handler log_handler,
+				 struct libinput *libinput,
+				 enum quirks_log_type log_type);
+
+/**
+ * Write a compiled cache of the quirks context to the given path. The
+ * cache is keyed to the modification times of the data files the
+ * context was initialized from and ignored by
+ * quirks_init_subsystem_with_cache() once any of them change.
+ *
+ * @return 0 on success or a negative errno on failure
+ */
+int
+quirks_context_write_cache(struct quirks_context *ctx, const char *path);
+
 /**
  * Clean up after ourselves. This function must be called
  * as the last call to the quirks subsystem.
@@ -191,6 +218,17 @@ DEFINE_UNREF_CLEANUP_FUNC(quirks_context);
 struct quirks_context *
 quirks_context_ref(struct quirks_context *ctx);
 
+/**
+ * Get the number of sections in the lookup index and the number of
+ * those that were candidates for the most recent
+ * quirks_fetch_for_device(), i.e. the sections that needed a full
+ * match. The candidate count is zero before the first fetch.
+ */
+void
+quirks_context_get_match_stats(struct quirks_context *ctx,
+			       size_t *nsections,
+			       size_t *ncandidates);
+
 /**
  * Fetch the quirks for a given device. If no quirks are defined, this
  * function returns NULL.
@@ -200,6 +238,14 @@ quirks_context_ref(struct quirks_context *ctx);
 struct quirks *
 quirks_fetch_for_device(struct quirks_context *ctx, struct udev_device *device);
 
+/**
+ * Increase the refcount by one.
+ *
+ * @return q
+ */
+struct quirks *
+quirks_ref(struct quirks *q);
+
 /**
  * Reduce the refcount by one. When the refcount reaches zero, the
  * associated struct is released.
@@ -0,0 +1,499 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "util-ring.h"
+
+#include "libinput-private.h"
+#include "reader-thread.h"
+
+/* Enough for ~100ms of a 10-finger touchscreen or a 8kHz mouse */
+#define READER_RING_SIZE 4096
+/* Number of input events read() at once */
+#define READER_BATCH_SIZE 128
+
+struct reader_device {
+	struct reader_thread *reader;
+	struct list link; /* reader->devices or reader->removed_devices */
+	int fd;
+	void (*dispatch)(void *data);
+	void *data;
+	enum libinput_source_priority priority;
+
+	struct ring ring; /* of struct input_event */
+
+	/* Set by the dispatch thread, protected by reader->lock */
+	bool removed;
+
+	/* Set by the reader thread if the ring was full. Whoever clears
+	 * it re-enables the fd, see reader_device_pause_full() */
+	atomic_bool paused_full;
+	/* Set by the reader thread if read() failed, a negative errno */
+	atomic_int error;
+};
+
+struct reader_thread {
+	struct libinput *libinput;
+	pthread_t thread;
+	atomic_bool stop;
+
+	int epoll_fd;  /* the reader thread's epoll set of device fds */
+	int wakeup_fd; /* eventfd to wake up the reader thread */
+	int notify_fd; /* eventfd in libinput's epoll set */
+	struct libinput_source *source;
+
+	/* Protects the removed flag of each device and removed_devices.
+	 * The reader thread holds it while handling the devices returned
+	 * by epoll_wait() */
+	pthread_mutex_t lock;
+
+	struct list devices;         /* dispatch thread only */
+	struct list removed_devices; /* freed by the reader thread */
+
+	/* Dispatch thread only: devices removed while dispatching stay
+	 * in the devices list until the dispatch loop is done, see
+	 * reader_thread_remove_device() */
+	bool dispatching;
+	bool removed_pending;
+
+	atomic_uint_fast64_t read_syscalls;
+	atomic_uint_fast64_t read_events;
+};
+
+static inline void
+reader_device_set_enabled(struct reader_device *rd, bool enabled)
+{
+	struct epoll_event ep = {
+		.events = enabled ? EPOLLIN : 0,
+		.data.ptr = rd,
+	};
+
+	epoll_ctl(rd->reader->epoll_fd, EPOLL_CTL_MOD, rd->fd, &ep);
+}
+
+static inline void
+reader_device_free(struct reader_device *rd)
+{
+	list_remove(&rd->link);
+	ring_destroy(&rd->ring);
+	free(rd);
+}
+
+/**
+ * Reader thread: the ring is full, stop polling the fd until the
+ * dispatch thread made some room. The fd is disabled before setting the
+ * flag so whoever clears the flag re-enables the fd after us.
+ */
+static void
+reader_device_pause_full(struct reader_device *rd)
+{
+	reader_device_set_enabled(rd, false);
+	atomic_store(&rd->paused_full, true);
+
+	/* The dispatch thread may have emptied the ring before it could
+	 * see our flag */
+	if (ring_free(&rd->ring) > 0 && atomic_exchange(&rd->paused_full, false))
+		reader_device_set_enabled(rd, true);
+}
+
+/**
+ * Reader thread: read one batch of events from the device into the
+ * ring. Only complete frames are published.
+ *
+ * @return true if the dispatch thread needs to be notified
+ */
+static bool
+reader_device_fill(struct reader_thread *reader, struct reader_device *rd)
+{
+	struct input_event events[READER_BATCH_SIZE];
+	size_t nfree = ring_free(&rd->ring);
+	ssize_t len;
+
+	if (nfree == 0) {
+		/* A frame larger than the ring, hand over what we have
+		 * rather than stalling forever. Otherwise the ring is full
+		 * of frames the dispatch thread hasn't read yet, wait for
+		 * it so the unpublished frame stays in one piece. */
+		if (rd->ring.pushed == rd->ring.size) {
+			ring_publish(&rd->ring);
+			return true;
+		}
+		reader_device_pause_full(rd);
+		return false;
+	}
+
+	len = read(rd->fd, events, min(nfree, ARRAY_LENGTH(events)) * sizeof(*events));
+	if (len < 0) {
+		if (errno == EAGAIN || errno == EINTR)
+			return false;
+
+		reader_device_set_enabled(rd, false);
+		atomic_store(&rd->error, -errno);
+		return true;
+	}
+
+	size_t nevents = len / sizeof(*events);
+	if (nevents == 0)
+		return false;
+
+	atomic_fetch_add_explicit(&reader->read_syscalls, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&reader->read_events, nevents, memory_order_relaxed);
+
+	/* Publish up to the last SYN_REPORT, anything after it stays
+	 * pushed until the rest of the frame arrives */
+	size_t npublish = 0;
+	for (size_t i = 0; i < nevents; i++) {
+		const struct input_event *ev = &events[i];
+
+		if (ev->type != EV_SYN)
+			continue;
+
+		if (ev->code == SYN_DROPPED) {
+			/* The dispatch thread syncs the device via libevdev,
+			 * that discards anything still in the fd. We must not
+			 * read it until the sync is complete. */
+			reader_device_set_enabled(rd, false);
+			ring_push(&rd->ring, events, i + 1);
+			ring_publish(&rd->ring);
+			return true;
+		}
+
+		if (ev->code == SYN_REPORT)
+			npublish = i + 1;
+	}
+
+	ring_push(&rd->ring, events, npublish);
+	if (npublish > 0)
+		ring_publish(&rd->ring);
+	ring_push(&rd->ring, events + npublish, nevents - npublish);
+
+	return npublish > 0;
+}
+
+static void *
+reader_thread_func(void *data)
+{
+	struct reader_thread *reader = data;
+	struct epoll_event ep[32];
+
+	while (!atomic_load(&reader->stop)) {
+		int count = epoll_wait(reader->epoll_fd, ep, ARRAY_LENGTH(ep), -1);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		bool notify = false;
+
+		pthread_mutex_lock(&reader->lock);
+		for (int i = 0; i < count; i++) {
+			struct reader_device *rd = ep[i].data.ptr;
+
+			if (rd == NULL) {
+				eventfd_t value;
+				eventfd_read(reader->wakeup_fd, &value);
+				continue;
+			}
+
+			if (rd->removed)
+				continue;
+
+			notify |= reader_device_fill(reader, rd);
+		}
+
+		/* Devices removed before we took the lock may have been in
+		 * ep but epoll_wait() won't return them again */
+		struct reader_device *rd;
+		list_for_each_safe(rd, &reader->removed_devices, link) {
+			reader_device_free(rd);
+		}
+		pthread_mutex_unlock(&reader->lock);
+
+		if (notify)
+			eventfd_write(reader->notify_fd, 1);
+	}
+
+	return NULL;
+}
+
+/* Dispatch all devices with events or an error of the given priority,
+ * or all of them if priority is -1 */
+static void
+reader_thread_dispatch_devices(struct reader_thread *reader, int priority)
+{
+	struct reader_device *rd;
+
+	list_for_each_safe(rd, &reader->devices, link) {
+		/* Removed by an earlier device's dispatch */
+		if (rd->removed)
+			continue;
+
+		if (priority != -1 && (int)rd->priority != priority)
+			continue;
+
+		if (ring_count(&rd->ring) == 0 && atomic_load(&rd->error) == 0)
+			continue;
+
+		rd->dispatch(rd->data);
+	}
+}
+
+/**
+ * Dispatch thread: the reader thread has new events.
+ */
+static void
+reader_thread_dispatch(void *data)
+{
+	struct reader_thread *reader = data;
+	struct libinput *libinput = reader->libinput;
+	struct reader_device *rd;
+	eventfd_t value;
+	bool pending = false;
+
+	eventfd_read(reader->notify_fd, &value);
+
+	/* A device's dispatch may remove any device, including the next
+	 * one in the list. Those are only flagged until we're done. */
+	reader->dispatching = true;
+
+	/* See LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS */
+	if (libinput->dispatch_flags & LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS) {
+		reader_thread_dispatch_devices(reader, LIBINPUT_SOURCE_PRIORITY_HIGH);
+		reader_thread_dispatch_devices(reader, LIBINPUT_SOURCE_PRIORITY_DEFAULT);
+	} else {
+		reader_thread_dispatch_devices(reader, -1);
+	}
+
+	reader->dispatching = false;
+	if (reader->removed_pending) {
+		pthread_mutex_lock(&reader->lock);
+		list_for_each_safe(rd, &reader->devices, link) {
+			if (!rd->removed)
+				continue;
+			list_remove(&rd->link);
+			list_append(&reader->removed_devices, &rd->link);
+		}
+		pthread_mutex_unlock(&reader->lock);
+		reader->removed_pending = false;
+	}
+
+	/* A device may have left events in its ring (e.g. because of the
+	 * dispatch budget), make sure we're called again */
+	list_for_each(rd, &reader->devices, link) {
+		if (ring_count(&rd->ring) > 0) {
+			pending = true;
+			break;
+		}
+	}
+
+	if (pending)
+		eventfd_write(reader->notify_fd, 1);
+}
+
+int
+reader_thread_new(struct libinput *libinput, struct reader_thread **reader_out)
+{
+	struct reader_thread *reader = zalloc(sizeof(*reader));
+	struct epoll_event ep = {
+		.events = EPOLLIN,
+		.data.ptr = NULL,
+	};
+	int rc;
+
+	reader->libinput = libinput;
+	reader->epoll_fd = -1;
+	reader->wakeup_fd = -1;
+	reader->notify_fd = -1;
+	atomic_init(&reader->stop, false);
+	atomic_init(&reader->read_syscalls, 0);
+	atomic_init(&reader->read_events, 0);
+	list_init(&reader->devices);
+	list_init(&reader->removed_devices);
+	pthread_mutex_init(&reader->lock, NULL);
+
+	reader->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	reader->wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	reader->notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (reader->epoll_fd < 0 || reader->wakeup_fd < 0 || reader->notify_fd < 0) {
+		rc = -errno;
+		goto err;
+	}
+
+	if (epoll_ctl(reader->epoll_fd, EPOLL_CTL_ADD, reader->wakeup_fd, &ep) < 0) {
+		rc = -errno;
+		goto err;
+	}
+
+	reader->source = libinput_add_fd(libinput,
+					 reader->notify_fd,
+					 reader_thread_dispatch,
+					 reader);
+	if (!reader->source) {
+		rc = -ENOMEM;
+		goto err;
+	}
+
+	/* pthread_create() returns the error, it doesn't set errno */
+	rc = pthread_create(&reader->thread, NULL, reader_thread_func, reader);
+	if (rc != 0) {
+		rc = -rc;
+		libinput_remove_source(libinput, reader->source);
+		goto err;
+	}
+
+	*reader_out = reader;
+	return 0;
+
+err:
+	if (reader->epoll_fd >= 0)
+		close(reader->epoll_fd);
+	if (reader->wakeup_fd >= 0)
+		close(reader->wakeup_fd);
+	if (reader->notify_fd >= 0)
+		close(reader->notify_fd);
+	pthread_mutex_destroy(&reader->lock);
+	free(reader);
+	return rc;
+}
+
+void
+reader_thread_destroy(struct reader_thread *reader)
+{
+	struct reader_device *rd;
+
+	if (!reader)
+		return;
+
+	atomic_store(&reader->stop, true);
+	eventfd_write(reader->wakeup_fd, 1);
+	pthread_join(reader->thread, NULL);
+
+	list_for_each_safe(rd, &reader->devices, link) {
+		reader_device_free(rd);
+	}
+	list_for_each_safe(rd, &reader->removed_devices, link) {
+		reader_device_free(rd);
+	}
+
+	libinput_remove_source(reader->libinput, reader->source);
+	close(reader->epoll_fd);
+	close(reader->wakeup_fd);
+	close(reader->notify_fd);
+	pthread_mutex_destroy(&reader->lock);
+	free(reader);
+}
+
+struct reader_device *
+reader_thread_add_device(struct reader_thread *reader,
+			 int fd,
+			 void (*dispatch)(void *data),
+			 void *data)
+{
+	struct reader_device *rd = zalloc(sizeof(*rd));
+	struct epoll_event ep = {
+		.events = EPOLLIN,
+		.data.ptr = rd,
+	};
+
+	rd->reader = reader;
+	rd->fd = fd;
+	rd->dispatch = dispatch;
+	rd->data = data;
+	rd->priority = LIBINPUT_SOURCE_PRIORITY_DEFAULT;
+	atomic_init(&rd->paused_full, false);
+	atomic_init(&rd->error, 0);
+	ring_init(&rd->ring, READER_RING_SIZE, sizeof(struct input_event));
+
+	/* Add to our list first, the reader thread may notify us
+	 * before epoll_ctl() returns */
+	list_append(&reader->devices, &rd->link);
+
+	if (epoll_ctl(reader->epoll_fd, EPOLL_CTL_ADD, fd, &ep) < 0) {
+		reader_device_free(rd);
+		return NULL;
+	}
+
+	return rd;
+}
+
+void
+reader_thread_remove_device(struct reader_thread *reader, struct reader_device *rd)
+{
+	pthread_mutex_lock(&reader->lock);
+	epoll_ctl(reader->epoll_fd, EPOLL_CTL_DEL, rd->fd, NULL);
+	rd->removed = true;
+	if (reader->dispatching) {
+		reader->removed_pending = true;
+	} else {
+		list_remove(&rd->link);
+		list_append(&reader->removed_devices, &rd->link);
+	}
+	pthread_mutex_unlock(&reader->lock);
+}
+
+void
+reader_device_set_priority(struct reader_device *rd,
+			   enum libinput_source_priority priority)
+{
+	rd->priority = priority;
+}
+
+void
+reader_thread_add_stats(struct reader_thread *reader, struct libinput_stats *stats)
+{
+	stats->read_syscalls += atomic_load(&reader->read_syscalls);
+	stats->read_events += atomic_load(&reader->read_events);
+}
+
+int
+reader_device_read(struct reader_device *rd,
+		   struct input_event *events,
+		   size_t max_events)
+{
+	size_t nevents = ring_pop(&rd->ring, events, max_events);
+
+	if (nevents > 0) {
+		if (atomic_exchange(&rd->paused_full, false))
+			reader_device_set_enabled(rd, true);
+		return nevents;
+	}
+
+	return atomic_load(&rd->error);
+}
+
+void
+reader_device_resume(struct reader_device *rd)
+{
+	reader_device_set_enabled(rd, true);
+}
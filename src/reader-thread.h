@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "config.h"
+
+#include <stddef.h>
+
+#include "libinput-private.h"
+#include "linux/input.h"
+
+/**
+ * An optional thread that reads the device fds on behalf of the
+ * dispatch thread (the thread calling libinput_dispatch()) and hands
+ * the events over through a lock-free ring per device. This keeps the
+ * kernel buffers drained even when the dispatch thread is busy.
+ *
+ * The reader thread never calls into libinput, it only reads events
+ * into the rings and wakes up the dispatch thread via an fd in
+ * libinput's epoll set. The reader_thread and reader_device functions
+ * must only be called from the dispatch thread.
+ */
+struct reader_thread;
+struct reader_device;
+
+/**
+ * Start the reader thread.
+ *
+ * @return 0 on success or a negative errno
+ */
+int
+reader_thread_new(struct libinput *libinput, struct reader_thread **reader_out);
+
+void
+reader_thread_destroy(struct reader_thread *reader);
+
+/**
+ * Add the fd to the reader thread. Whenever events are available,
+ * dispatch(data) is called from libinput_dispatch() and should call
+ * reader_device_read() until it returns less than requested.
+ */
+struct reader_device *
+reader_thread_add_device(struct reader_thread *reader,
+			 int fd,
+			 void (*dispatch)(void *data),
+			 void *data);
+
+/**
+ * Stop reading from the device's fd. The reader device must not be
+ * used after this call.
+ */
+void
+reader_thread_remove_device(struct reader_thread *reader,
+			    struct reader_device *rd);
+
+/**
+ * Devices with a high priority are dispatched first if
+ * LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS is set.
+ */
+void
+reader_device_set_priority(struct reader_device *rd,
+			   enum libinput_source_priority priority);
+
+/**
+ * Fill in the counters collected by the reader thread.
+ */
+void
+reader_thread_add_stats(struct reader_thread *reader, struct libinput_stats *stats);
+
+/**
+ * Read up to max_events events that the reader thread read from the
+ * device. Only complete SYN_REPORT-terminated frames are handed over.
+ *
+ * If the reader thread encounters a SYN_DROPPED it stops reading from
+ * the device after that event and the caller must call
+ * reader_device_resume() once it has synced the device state.
+ *
+ * @return the number of events, or a negative errno if the reader
+ * thread failed to read from the device and all events have been read
+ */
+int
+reader_device_read(struct reader_device *rd,
+		   struct input_event *events,
+		   size_t max_events);
+
+/**
+ * Resume reading after a SYN_DROPPED.
+ */
+void
+reader_device_resume(struct reader_device *rd);
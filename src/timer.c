@@ -30,6 +30,7 @@
 #include <unistd.h>
 
 #include "libinput-private.h"
+#include "libinput-uring.h"
 #include "timer.h"
 
 void
@@ -50,8 +51,7 @@ libinput_timer_init(struct libinput_timer *timer,
 void
 libinput_timer_destroy(struct libinput_timer *timer)
 {
-	if (timer->link.prev != NULL && timer->link.next != NULL &&
-	    !list_empty(&timer->link)) {
+	if (heap_node_is_queued(&timer->node)) {
 		log_bug_libinput(timer->libinput,
 				 "timer: %s has not been cancelled\n",
 				 timer->timer_name);
@@ -64,24 +64,37 @@ static void
 libinput_timer_arm_timer_fd(struct libinput *libinput)
 {
 	int r;
-	struct libinput_timer *timer;
+	struct heap_node *first = heap_first(&libinput->timer.heap);
 	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
 	usec_t earliest_expire = usec_from_uint64_t(UINT64_MAX);
 
-	list_for_each(timer, &libinput->timer.list, link) {
-		if (usec_cmp(timer->expire, earliest_expire) < 0)
-			earliest_expire = timer->expire;
+	if (first) {
+		struct libinput_timer *timer =
+			container_of(first, struct libinput_timer, node);
+		earliest_expire = timer->expire;
+	}
+
+	/* Most timer updates re-arm a timer that isn't the earliest one,
+	 * the timerfd is already programmed correctly in that case */
+	if (usec_cmp(earliest_expire, libinput->timer.next_expiry) == 0) {
+		libinput->stats.timer_syscalls_skipped++;
+		return;
 	}
 
 	if (usec_ne(earliest_expire, UINT64_MAX)) {
 		its.it_value = usec_to_timespec(earliest_expire);
 	}
 
+	libinput->stats.timer_syscalls++;
 	r = timerfd_settime(libinput->timer.fd, TFD_TIMER_ABSTIME, &its, NULL);
-	if (r)
+	if (r) {
 		log_error(libinput,
 			  "timer: timerfd_settime error: %s\n",
 			  strerror(errno));
+		/* Force a retry on the next update */
+		libinput->timer.next_expiry = usec_from_uint64_t(0);
+		return;
+	}
 
 	libinput->timer.next_expiry = earliest_expire;
 }
@@ -119,7 +132,13 @@ libinput_timer_set_flags(struct libinput_timer *timer, usec_t expire, uint32_t f
 	assert(usec_ne(expire, 0));
 
 	if (usec_is_zero(timer->expire))
-		list_insert(&timer->libinput->timer.list, &timer->link);
+		heap_insert(&timer->libinput->timer.heap,
+			    &timer->node,
+			    usec_as_uint64_t(expire));
+	else
+		heap_update(&timer->libinput->timer.heap,
+			    &timer->node,
+			    usec_as_uint64_t(expire));
 
 	timer->expire = expire;
 	libinput_timer_arm_timer_fd(timer->libinput);
@@ -131,44 +150,48 @@ libinput_timer_set(struct libinput_timer *timer, usec_t expire)
 	libinput_timer_set_flags(timer, expire, TIMER_FLAG_NONE);
 }
 
+static void
+libinput_timer_remove(struct libinput_timer *timer)
+{
+	timer->expire = usec_from_uint64_t(0);
+	heap_remove(&timer->libinput->timer.heap, &timer->node);
+}
+
 void
 libinput_timer_cancel(struct libinput_timer *timer)
 {
 	if (usec_is_zero(timer->expire))
 		return;
 
-	timer->expire = usec_from_uint64_t(0);
-	list_remove(&timer->link);
+	libinput_timer_remove(timer);
 	libinput_timer_arm_timer_fd(timer->libinput);
 }
 
 static void
 libinput_timer_handler(struct libinput *libinput, usec_t now)
 {
-	struct libinput_timer *timer;
-
-restart:
-	list_for_each_safe(timer, &libinput->timer.list, link) {
-		if (usec_is_zero(timer->expire))
-			continue;
-
-		if (usec_cmp(timer->expire, now) <= 0) {
-			/* Clear the timer before calling timer_func,
-			   as timer_func may re-arm it */
-			libinput_timer_cancel(timer);
-			timer->timer_func(now, timer->timer_func_data);
-
-			/*
-			 * Restart the loop. We can't use
-			 * list_for_each_safe() here because that only
-			 * allows removing one (our) timer per timer_func.
-			 * But the timer func may trigger another unrelated
-			 * timer to be cancelled and removed, causing a
-			 * segfault.
-			 */
-			goto restart;
-		}
+	struct heap_node *node;
+
+	/*
+	 * The timer func may set or cancel any timer, including
+	 * its own, so we always look at the current earliest timer
+	 * and stop at the first one that's not expired yet.
+	 */
+	while ((node = heap_first(&libinput->timer.heap))) {
+		struct libinput_timer *timer =
+			container_of(node, struct libinput_timer, node);
+
+		if (usec_cmp(timer->expire, now) > 0)
+			break;
+
+		/* Clear the timer before calling timer_func,
+		   as timer_func may re-arm it */
+		libinput_timer_remove(timer);
+		libinput->stats.timer_fires++;
+		timer->timer_func(now, timer->timer_func_data);
 	}
+
+	libinput_timer_arm_timer_fd(libinput);
 }
 
 static void
@@ -179,7 +202,16 @@ libinput_timer_dispatch(void *data)
 	uint64_t discard;
 	int r;
 
-	r = read(libinput->timer.fd, &discard, sizeof(discard));
+	if (libinput->timer.uring_source) {
+		/* Each expiry is a separate completion, drain them all */
+		do {
+			r = libinput_uring_source_read(libinput->timer.uring_source,
+						       &discard,
+						       sizeof(discard));
+		} while (r == (int)sizeof(discard));
+	} else {
+		r = read(libinput->timer.fd, &discard, sizeof(discard));
+	}
 	if (r == -1 && errno != EAGAIN)
 		log_bug_libinput(libinput,
 				 "timer: error %d reading from timerfd (%s)",
@@ -201,13 +233,24 @@ libinput_timer_subsys_init(struct libinput *libinput)
 	if (libinput->timer.fd < 0)
 		return -1;
 
-	list_init(&libinput->timer.list);
+	heap_init(&libinput->timer.heap);
+
+	if (libinput->uring) {
+		libinput->timer.uring_source =
+			libinput_uring_add_source(libinput->uring,
+						  libinput->timer.fd,
+						  libinput_timer_dispatch,
+						  libinput);
+		if (libinput->timer.uring_source)
+			return 0;
+	}
 
 	libinput->timer.source = libinput_add_fd(libinput,
 						 libinput->timer.fd,
 						 libinput_timer_dispatch,
 						 libinput);
 	if (!libinput->timer.source) {
+		heap_destroy(&libinput->timer.heap);
 		close(libinput->timer.fd);
 		return -1;
 	}
@@ -219,10 +262,12 @@ void
 libinput_timer_subsys_destroy(struct libinput *libinput)
 {
 #ifndef NDEBUG
-	if (!list_empty(&libinput->timer.list)) {
-		struct libinput_timer *t;
+	if (!heap_empty(&libinput->timer.heap)) {
+		struct heap_node *node;
 
-		list_for_each(t, &libinput->timer.list, link) {
+		heap_for_each(node, &libinput->timer.heap) {
+			struct libinput_timer *t =
+				container_of(node, struct libinput_timer, node);
 			log_bug_libinput(libinput,
 					 "timer: %s still present on shutdown\n",
 					 t->timer_name);
@@ -231,9 +276,13 @@ libinput_timer_subsys_destroy(struct libinput *libinput)
 #endif
 
 	/* All timer users should have destroyed their timers now */
-	assert(list_empty(&libinput->timer.list));
+	assert(heap_empty(&libinput->timer.heap));
+	heap_destroy(&libinput->timer.heap);
 
-	libinput_remove_source(libinput, libinput->timer.source);
+	if (libinput->timer.uring_source)
+		libinput_uring_remove_source(libinput->timer.uring_source);
+	else
+		libinput_remove_source(libinput, libinput->timer.source);
 	close(libinput->timer.fd);
 }
 
@@ -35,7 +35,7 @@ struct libinput;
 struct libinput_timer {
 	struct libinput *libinput;
 	char *timer_name;
-	struct list link;
+	struct heap_node node;
 	usec_t expire; /* in absolute us CLOCK_MONOTONIC */
 	void (*timer_func)(usec_t now, void *timer_func_data);
 	void *timer_func_data;
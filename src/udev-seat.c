@@ -69,34 +69,68 @@ filter_duplicates(struct udev_seat *udev_seat, struct udev_device *udev_device)
 	return ignore_device;
 }
 
+static inline const char *
+device_get_seat(struct udev_device *udev_device)
+{
+	const char *device_seat;
+
+	device_seat = udev_device_get_property_value(udev_device, "ID_SEAT");
+
+	return device_seat ? device_seat : default_seat;
+}
+
+static inline const char *
+device_get_seat_name(struct udev_device *udev_device)
+{
+	const char *seat_name;
+
+	seat_name = udev_device_get_property_value(udev_device, "WL_SEAT");
+
+	return seat_name ? seat_name : default_seat_name;
+}
+
+static inline bool
+device_is_for_input(struct udev_device *udev_device, struct udev_input *input)
+{
+	return streq(device_get_seat(udev_device), input->seat_id) &&
+	       !ignore_litest_test_suite_device(udev_device);
+}
+
+static inline bool
+device_is_known(struct udev_device *udev_device, struct udev_input *input)
+{
+	struct udev_seat *seat;
+
+	list_for_each(seat, &input->base.seat_list, base.link) {
+		if (filter_duplicates(seat, udev_device))
+			return true;
+	}
+
+	return false;
+}
+
 static int
 device_added(struct udev_device *udev_device,
 	     struct udev_input *input,
-	     const char *seat_name)
+	     const char *seat_name,
+	     struct evdev_probe *probe)
 {
 	struct evdev_device *device;
 	const char *devnode, *sysname;
 	const char *device_seat, *output_name;
 	struct udev_seat *seat;
 
-	device_seat = udev_device_get_property_value(udev_device, "ID_SEAT");
-	if (!device_seat)
-		device_seat = default_seat;
-
-	if (!streq(device_seat, input->seat_id))
+	if (!device_is_for_input(udev_device, input))
 		return 0;
 
-	if (ignore_litest_test_suite_device(udev_device))
-		return 0;
+	device_seat = device_get_seat(udev_device);
 
 	devnode = udev_device_get_devnode(udev_device);
 	sysname = udev_device_get_sysname(udev_device);
 
 	/* Search for matching logical seat */
 	if (!seat_name)
-		seat_name = udev_device_get_property_value(udev_device, "WL_SEAT");
-	if (!seat_name)
-		seat_name = default_seat_name;
+		seat_name = device_get_seat_name(udev_device);
 
 	seat = udev_seat_get_named(input, seat_name);
 
@@ -115,7 +149,7 @@ device_added(struct udev_device *udev_device,
 			return -1;
 	}
 
-	device = evdev_device_create(&seat->base, udev_device);
+	device = evdev_device_create_from_probe(&seat->base, udev_device, probe);
 	libinput_seat_unref(&seat->base);
 
 	if (device == EVDEV_UNHANDLED_DEVICE) {
@@ -161,10 +195,23 @@ device_removed(struct udev_device *udev_device, struct udev_input *input)
 	}
 }
 
+/**
+ * Devices are added in three steps: all devices are opened first (on
+ * this thread, open_restricted() is the caller's), then their
+ * capabilities are read in parallel while this thread looks up their
+ * quirks, and finally each device is set up in enumeration order.
+ * Reading the capabilities is the bulk of the time spent per device,
+ * so on machines with many input nodes the startup time is closer to
+ * the slowest device than the sum of all.
+ */
 static int
 udev_input_add_devices(struct udev_input *input, struct udev *udev)
 {
 	struct udev_list_entry *entry;
+	_autofree_ struct udev_device **devices = NULL;
+	_autofree_ struct evdev_probe *probes = NULL;
+	size_t ndevices = 0, nalloc = 0;
+	int rc = 0;
 
 	_unref_(udev_enumerate) *e = udev_enumerate_new(udev);
 	udev_enumerate_add_match_subsystem(e, "input");
@@ -190,11 +237,35 @@ udev_input_add_devices(struct udev_input *input, struct udev *udev)
 			continue;
 		}
 
-		if (device_added(device, input, NULL) < 0) {
-			return -1;
+		/* Devices kept across a fast resume */
+		if (!device_is_for_input(device, input) ||
+		    device_is_known(device, input))
+			continue;
+
+		if (ndevices == nalloc) {
+			nalloc = max(nalloc * 2, 16U);
+			devices = realloc(devices, nalloc * sizeof(*devices));
+			probes = realloc(probes, nalloc * sizeof(*probes));
+			if (!devices || !probes)
+				abort();
 		}
+
+		devices[ndevices] = steal(&device);
+		evdev_probe_open(&input->base, &probes[ndevices], devices[ndevices]);
+		ndevices++;
 	}
-	return 0;
+
+	evdev_probe_run_all(&input->base, probes, ndevices);
+
+	for (size_t i = 0; i < ndevices; i++) {
+		if (rc == 0 && device_added(devices[i], input, NULL, &probes[i]) < 0)
+			rc = -1;
+
+		evdev_probe_release(&input->base, &probes[i]);
+		udev_device_unref(devices[i]);
+	}
+
+	return rc;
 }
 
 static void
@@ -213,7 +284,7 @@ evdev_udev_handler(void *data)
 		return;
 
 	if (streq(action, "add"))
-		device_added(udev_device, input, NULL);
+		device_added(udev_device, input, NULL, NULL);
 	else if (streq(action, "remove"))
 		device_removed(udev_device, input);
 }
@@ -233,6 +304,69 @@ udev_input_remove_devices(struct udev_input *input)
 	}
 }
 
+static void
+udev_input_suspend_devices(struct udev_input *input)
+{
+	struct evdev_device *device;
+	struct udev_seat *seat;
+
+	list_for_each(seat, &input->base.seat_list, base.link) {
+		list_for_each(device, &seat->base.devices_list, base.link) {
+			/* Already suspended by its dispatch or the caller,
+			 * whoever did that resumes it */
+			if (device->fd == -1)
+				continue;
+
+			evdev_device_suspend(device);
+			device->is_suspended_with_context = true;
+		}
+	}
+}
+
+/**
+ * Resume the devices kept by udev_input_suspend_devices() that are still
+ * the same device at the same node on the same seat, remove all others.
+ * Devices that are new or moved are added by udev_input_add_devices()
+ * afterwards.
+ */
+static void
+udev_input_resume_devices(struct udev_input *input, struct udev *udev)
+{
+	struct evdev_device *device;
+	struct udev_seat *seat;
+
+	list_for_each_safe(seat, &input->base.seat_list, base.link) {
+		libinput_seat_ref(&seat->base);
+		list_for_each_safe(device, &seat->base.devices_list, base.link) {
+			if (!device->is_suspended_with_context)
+				continue;
+
+			device->is_suspended_with_context = false;
+
+			const char *syspath = udev_device_get_syspath(device->udev_device);
+			_unref_(udev_device) *current =
+				udev_device_new_from_syspath(udev, syspath);
+
+			/* The udev properties may have changed while suspended,
+			 * e.g. on multi-seat machines where devices are
+			 * assigned to seats. Switch states may have changed
+			 * too, re-adding the device is the simplest way to get
+			 * all paired devices back in sync */
+			if (!current || !udev_device_get_is_initialized(current) ||
+			    udev_device_get_devnum(current) !=
+				    udev_device_get_devnum(device->udev_device) ||
+			    !device_is_for_input(current, input) ||
+			    !streq(device_get_seat_name(current),
+				   device->base.seat->logical_name) ||
+			    evdev_udev_device_should_be_ignored(current) ||
+			    device->seat_caps & EVDEV_DEVICE_SWITCH ||
+			    evdev_device_resume(device) < 0)
+				evdev_device_remove(device);
+		}
+		libinput_seat_unref(&seat->base);
+	}
+}
+
 static void
 udev_input_disable(struct libinput *libinput)
 {
@@ -246,7 +380,10 @@ udev_input_disable(struct libinput *libinput)
 	libinput_remove_source(&input->base, input->udev_monitor_source);
 	input->udev_monitor_source = NULL;
 
-	udev_input_remove_devices(input);
+	if (input->fast_resume)
+		udev_input_suspend_devices(input);
+	else
+		udev_input_remove_devices(input);
 }
 
 static int
@@ -288,6 +425,8 @@ udev_input_enable(struct libinput *libinput)
 		return -1;
 	}
 
+	udev_input_resume_devices(input, udev);
+
 	if (udev_input_add_devices(input, udev) < 0) {
 		udev_input_disable(libinput);
 		return -1;
@@ -304,6 +443,9 @@ udev_input_destroy(struct libinput *input)
 	if (input == NULL)
 		return;
 
+	/* Devices kept by a fast suspend */
+	udev_input_remove_devices(udev_input);
+
 	udev_unref(udev_input->udev);
 	free(udev_input->seat_id);
 }
@@ -357,7 +499,7 @@ udev_device_change_seat(struct libinput_device *device, const char *seat_name)
 
 	udev_device_ref(udev_device);
 	device_removed(udev_device, input);
-	rc = device_added(udev_device, input, seat_name);
+	rc = device_added(udev_device, input, seat_name, NULL);
 	udev_device_unref(udev_device);
 
 	return rc;
@@ -432,3 +574,18 @@ libinput_udev_assign_seat(struct libinput *libinput, const char *seat_id)
 
 	return 0;
 }
+
+LIBINPUT_EXPORT int
+libinput_udev_set_fast_resume(struct libinput *libinput, int enable)
+{
+	struct udev_input *input = (struct udev_input *)libinput;
+
+	if (libinput->interface_backend != &interface_backend) {
+		log_bug_client(libinput, "Mismatching backends.\n");
+		return -1;
+	}
+
+	input->fast_resume = !!enable;
+
+	return 0;
+}
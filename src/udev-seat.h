@@ -40,6 +40,7 @@ struct udev_input {
 	struct udev_monitor *udev_monitor;
 	struct libinput_source *udev_monitor_source;
 	char *seat_id;
+	bool fast_resume;
 };
 
 #endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "util-heap.h"
+
+static inline bool
+heap_node_before(const struct heap_node *a, const struct heap_node *b)
+{
+	if (a->key != b->key)
+		return a->key < b->key;
+
+	return a->seq > b->seq;
+}
+
+static inline void
+heap_set(struct heap *heap, size_t index, struct heap_node *node)
+{
+	heap->nodes[index] = node;
+	node->index = index;
+}
+
+static void
+heap_sift_up(struct heap *heap, size_t index)
+{
+	struct heap_node *node = heap->nodes[index];
+
+	while (index > 1) {
+		size_t parent = index / 2;
+
+		if (!heap_node_before(node, heap->nodes[parent]))
+			break;
+
+		heap_set(heap, index, heap->nodes[parent]);
+		index = parent;
+	}
+
+	heap_set(heap, index, node);
+}
+
+static void
+heap_sift_down(struct heap *heap, size_t index)
+{
+	struct heap_node *node = heap->nodes[index];
+
+	while (true) {
+		size_t child = index * 2;
+
+		if (child > heap->count)
+			break;
+
+		if (child + 1 <= heap->count &&
+		    heap_node_before(heap->nodes[child + 1], heap->nodes[child]))
+			child++;
+
+		if (!heap_node_before(heap->nodes[child], node))
+			break;
+
+		heap_set(heap, index, heap->nodes[child]);
+		index = child;
+	}
+
+	heap_set(heap, index, node);
+}
+
+void
+heap_init(struct heap *heap)
+{
+	*heap = (struct heap){ 0 };
+}
+
+void
+heap_destroy(struct heap *heap)
+{
+	assert(heap_empty(heap) || !"heap is not empty");
+
+	free(heap->nodes);
+	heap_init(heap);
+}
+
+void
+heap_insert(struct heap *heap, struct heap_node *node, uint64_t key)
+{
+	assert(!heap_node_is_queued(node) ||
+	       !"heap node is already queued, node used twice?");
+
+	if (heap->count == heap->size) {
+		size_t size = heap->size > 0 ? heap->size * 2 : 16;
+		struct heap_node **nodes =
+			realloc(heap->nodes, (size + 1) * sizeof(*nodes));
+
+		if (!nodes)
+			abort();
+
+		heap->nodes = nodes;
+		heap->size = size;
+	}
+
+	node->key = key;
+	node->seq = ++heap->seq;
+	heap->count++;
+	heap_set(heap, heap->count, node);
+	heap_sift_up(heap, heap->count);
+}
+
+void
+heap_update(struct heap *heap, struct heap_node *node, uint64_t key)
+{
+	assert(heap_node_is_queued(node) || !"heap node is not queued");
+	assert(heap->nodes[node->index] == node);
+
+	uint64_t old_key = node->key;
+
+	node->key = key;
+	if (key < old_key)
+		heap_sift_up(heap, node->index);
+	else if (key > old_key)
+		heap_sift_down(heap, node->index);
+}
+
+void
+heap_remove(struct heap *heap, struct heap_node *node)
+{
+	assert(heap_node_is_queued(node) || !"heap node is not queued");
+	assert(heap->nodes[node->index] == node);
+
+	size_t index = node->index;
+	struct heap_node *last = heap->nodes[heap->count];
+
+	heap->count--;
+	node->index = 0;
+
+	if (last == node)
+		return;
+
+	heap_set(heap, index, last);
+	if (index > 1 && heap_node_before(last, heap->nodes[index / 2]))
+		heap_sift_up(heap, index);
+	else
+		heap_sift_down(heap, index);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Intrusive binary min-heap, sorted by a 64-bit key. The heap node is
+ * embedded in the caller's struct and the container is retrieved with
+ * container_of(). Use like this:
+ *
+ * @code
+ *	struct foo {
+ *	   struct heap heap_of_bars;
+ *	};
+ *
+ *	struct bar {
+ *	   struct heap_node node;
+ *	};
+ *
+ *	heap_init(&f->heap_of_bars);
+ *	heap_insert(&f->heap_of_bars, &b->node, 1234);
+ *	struct heap_node *first = heap_first(&f->heap_of_bars);
+ *	heap_remove(&f->heap_of_bars, &b->node);
+ *	heap_destroy(&f->heap_of_bars);
+ * @endcode
+ *
+ * Insertion, removal and key updates are O(log n), heap_first() is O(1).
+ * Nodes with identical keys are returned most recently inserted first.
+ */
+struct heap_node {
+	uint64_t key;
+	uint64_t seq;
+	size_t index; /* 1-based index into heap->nodes, 0 if not queued */
+};
+
+struct heap {
+	struct heap_node **nodes; /* nodes[0] is unused */
+	size_t count;
+	size_t size;
+	uint64_t seq;
+};
+
+void
+heap_init(struct heap *heap);
+
+/**
+ * Release the memory used by the heap. The heap must be empty.
+ */
+void
+heap_destroy(struct heap *heap);
+
+/**
+ * Insert a node that is not currently in the heap.
+ */
+void
+heap_insert(struct heap *heap, struct heap_node *node, uint64_t key);
+
+/**
+ * Change the key of a node that is already in the heap.
+ */
+void
+heap_update(struct heap *heap, struct heap_node *node, uint64_t key);
+
+/**
+ * Remove a node from the heap. Removing a node is only possible once,
+ * use heap_node_is_queued() to check.
+ */
+void
+heap_remove(struct heap *heap, struct heap_node *node);
+
+/**
+ * Return the node with the lowest key or NULL if the heap is empty
+ */
+static inline struct heap_node *
+heap_first(const struct heap *heap)
+{
+	return heap->count > 0 ? heap->nodes[1] : NULL;
+}
+
+static inline bool
+heap_empty(const struct heap *heap)
+{
+	return heap->count == 0;
+}
+
+static inline size_t
+heap_length(const struct heap *heap)
+{
+	return heap->count;
+}
+
+static inline bool
+heap_node_is_queued(const struct heap_node *node)
+{
+	return node->index != 0;
+}
+
+/**
+ * Iterate over all nodes in the heap in unspecified order. The heap
+ * must not be modified while iterating.
+ */
+#define heap_for_each(node_, heap_) \
+	for (size_t _i = 1; \
+	     _i <= (heap_)->count && ((node_) = (heap_)->nodes[_i]); \
+	     _i++)
@@ -84,6 +84,9 @@ event_type_to_str(enum libinput_event_type evtype)
 	case LIBINPUT_EVENT_TOUCH_FRAME:
 		type = "TOUCH_FRAME";
 		break;
+	case LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME:
+		type = "TOUCH_AGGREGATE_FRAME";
+		break;
 	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
 		type = "GESTURE_SWIPE_BEGIN";
 		break;
@@ -120,6 +123,9 @@ event_type_to_str(enum libinput_event_type evtype)
 	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
 		type = "TABLET_TOOL_BUTTON";
 		break;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
+		type = "TABLET_TOOL_AXIS_BATCH";
+		break;
 	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
 		type = "TABLET_PAD_BUTTON";
 		break;
@@ -777,6 +783,69 @@ print_touch_event(struct libinput_event *ev, const struct libinput_print_options
 	return strdup_printf("%s\t%s%s", time, slot ? slot : "", pos ? pos : "");
 }
 
+static char *
+print_touch_aggregate_event(struct libinput_event *ev,
+			    const struct libinput_print_options *opts)
+{
+	struct libinput_event_touch_aggregate *t =
+		libinput_event_get_touch_aggregate_event(ev);
+	unsigned int count = libinput_event_touch_aggregate_get_touch_count(t);
+	char time[16];
+	_autofree_ char *touches = safe_strdup("");
+
+	print_event_time(time,
+			 opts->start_time,
+			 libinput_event_touch_aggregate_get_time(t));
+
+	for (unsigned int i = 0; i < count; i++) {
+		enum libinput_event_type type =
+			libinput_event_touch_aggregate_get_touch_type(t, i);
+		const char *state;
+		_autofree_ char *pos = NULL;
+		char *tmp;
+
+		switch (type) {
+		case LIBINPUT_EVENT_TOUCH_DOWN:
+			state = "down";
+			break;
+		case LIBINPUT_EVENT_TOUCH_MOTION:
+			state = "motion";
+			break;
+		case LIBINPUT_EVENT_TOUCH_UP:
+			state = "up";
+			break;
+		default:
+			state = "cancel";
+			break;
+		}
+
+		if (type == LIBINPUT_EVENT_TOUCH_DOWN ||
+		    type == LIBINPUT_EVENT_TOUCH_MOTION) {
+			double x = libinput_event_touch_aggregate_get_x_transformed(
+				t,
+				i,
+				opts->screen_width);
+			double y = libinput_event_touch_aggregate_get_y_transformed(
+				t,
+				i,
+				opts->screen_height);
+			pos = strdup_printf(" %5.2f/%5.2f", x, y);
+		}
+
+		tmp = strdup_printf("%s%s%d (%d) %s%s",
+				    touches,
+				    i > 0 ? ", " : "",
+				    libinput_event_touch_aggregate_get_slot(t, i),
+				    libinput_event_touch_aggregate_get_seat_slot(t, i),
+				    state,
+				    pos ? pos : "");
+		free(touches);
+		touches = tmp;
+	}
+
+	return strdup_printf("%s\t%u touches: %s", time, count, touches);
+}
+
 static char *
 print_gesture_event_without_coords(struct libinput_event *ev,
 				   const struct libinput_print_options *opts)
@@ -1054,6 +1123,9 @@ libinput_event_to_str(struct libinput_event *ev,
 	case LIBINPUT_EVENT_TOUCH_FRAME:
 		event_str = print_touch_event(ev, &opts);
 		break;
+	case LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME:
+		event_str = print_touch_aggregate_event(ev, &opts);
+		break;
 	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
 		event_str = print_gesture_event_without_coords(ev, &opts);
 		break;
@@ -1079,6 +1151,7 @@ libinput_event_to_str(struct libinput_event *ev,
 		event_str = print_gesture_event_without_coords(ev, &opts);
 		break;
 	case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
 		event_str = print_tablet_axis_event(ev, &opts);
 		break;
 	case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "config.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "util-macros.h"
+#include "util-mem.h"
+
+/**
+ * A lock-free single-producer single-consumer ring buffer of fixed-size
+ * elements. The producer and the consumer may run on different
+ * threads but each side must only ever be used by one thread.
+ *
+ * The producer pushes elements with ring_push() and makes them visible
+ * to the consumer with ring_publish(), so a group of elements (e.g. an
+ * event frame) can be handed over at once:
+ *
+ * @code
+ *	ring_init(&r, 256, sizeof(struct foo));
+ *
+ *	// producer
+ *	if (ring_free(&r) >= nfoos) {
+ *	   ring_push(&r, foos, nfoos);
+ *	   ring_publish(&r);
+ *	}
+ *
+ *	// consumer
+ *	size_t n = ring_pop(&r, foos, ARRAY_LENGTH(foos));
+ * @endcode
+ */
+struct ring {
+	char *data;
+	size_t size; /* number of elements, a power of two */
+	size_t elem_size;
+	size_t pushed;       /* producer only: pushed but not yet published */
+	_Atomic size_t head; /* written by the producer only */
+	_Atomic size_t tail; /* written by the consumer only */
+};
+
+static inline void
+ring_init(struct ring *ring, size_t nelems, size_t elem_size)
+{
+	size_t size = 1;
+
+	while (size < nelems)
+		size <<= 1;
+
+	ring->data = zalloc(size * elem_size);
+	ring->size = size;
+	ring->elem_size = elem_size;
+	ring->pushed = 0;
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+}
+
+static inline void
+ring_destroy(struct ring *ring)
+{
+	free(ring->data);
+	ring->data = NULL;
+	ring->size = 0;
+}
+
+/**
+ * Producer only: the number of elements that can be pushed.
+ */
+static inline size_t
+ring_free(struct ring *ring)
+{
+	size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	return ring->size - (head + ring->pushed - tail);
+}
+
+/**
+ * Producer only: append nelems elements, invisible to the consumer
+ * until the next ring_publish(). The caller must ensure there is
+ * enough space, see ring_free().
+ */
+static inline void
+ring_push(struct ring *ring, const void *elems, size_t nelems)
+{
+	assert(nelems <= ring_free(ring));
+
+	size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	size_t start = (head + ring->pushed) & (ring->size - 1);
+	size_t first = min(nelems, ring->size - start);
+	const char *src = elems;
+
+	memcpy(ring->data + start * ring->elem_size, src, first * ring->elem_size);
+	memcpy(ring->data,
+	       src + first * ring->elem_size,
+	       (nelems - first) * ring->elem_size);
+
+	ring->pushed += nelems;
+}
+
+/**
+ * Producer only: make all pushed elements visible to the consumer.
+ */
+static inline void
+ring_publish(struct ring *ring)
+{
+	size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+	atomic_store_explicit(&ring->head, head + ring->pushed, memory_order_release);
+	ring->pushed = 0;
+}
+
+/**
+ * Consumer only: the number of elements available to ring_pop().
+ */
+static inline size_t
+ring_count(struct ring *ring)
+{
+	size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+	return head - tail;
+}
+
+/**
+ * Consumer only: remove up to max_elems published elements from the
+ * ring and copy them into elems.
+ *
+ * @return the number of elements copied
+ */
+static inline size_t
+ring_pop(struct ring *ring, void *elems, size_t max_elems)
+{
+	size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	size_t count = ring_count(ring);
+	size_t nelems = min(count, max_elems);
+	size_t start = tail & (ring->size - 1);
+	size_t first = min(nelems, ring->size - start);
+	char *dest = elems;
+
+	memcpy(dest, ring->data + start * ring->elem_size, first * ring->elem_size);
+	memcpy(dest + first * ring->elem_size,
+	       ring->data,
+	       (nelems - first) * ring->elem_size);
+
+	atomic_store_explicit(&ring->tail, tail + nelems, memory_order_release);
+
+	return nelems;
+}
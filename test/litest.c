@@ -3678,6 +3678,9 @@ litest_event_type_str(enum libinput_event_type type)
 	case LIBINPUT_EVENT_TOUCH_FRAME:
 		str = "TOUCH FRAME";
 		break;
+	case LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME:
+		str = "TOUCH AGGREGATE FRAME";
+		break;
 	case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
 		str = "GESTURE SWIPE BEGIN";
 		break;
@@ -3714,6 +3717,9 @@ litest_event_type_str(enum libinput_event_type type)
 	case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
 		str = "TABLET TOOL BUTTON";
 		break;
+	case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
+		str = "TABLET TOOL AXIS BATCH";
+		break;
 	case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
 		str = "TABLET PAD BUTTON";
 		break;
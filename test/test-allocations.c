@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2026 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/* This file replaces malloc() and friends for the whole process, it is
+ * built into its own test executable so the main test suite keeps the
+ * allocator of valgrind or the sanitizers.
+ */
+
+#include <config.h>
+
+#include <libinput.h>
+#include <stdlib.h>
+#include <valgrind/valgrind.h>
+
+#include "litest.h"
+
+/* gcc defines __SANITIZE_ADDRESS__, clang only has __has_feature() */
+#if defined(__SANITIZE_ADDRESS__)
+#define HAVE_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define HAVE_ASAN 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(HAVE_ASAN)
+#define HAVE_MALLOC_INTERPOSE 1
+
+extern void *
+__libc_malloc(size_t size);
+extern void *
+__libc_calloc(size_t nmemb, size_t size);
+extern void *
+__libc_realloc(void *ptr, size_t size);
+
+/* Only counted while a test has count_allocations set */
+static bool count_allocations;
+static size_t nallocations;
+
+void *
+malloc(size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+START_TEST(dispatch_no_allocations)
+{
+#ifndef HAVE_MALLOC_INTERPOSE
+	return LITEST_SKIP;
+#else
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+
+	/* valgrind replaces malloc before we get to see it */
+	if (RUNNING_ON_VALGRIND)
+		return LITEST_SKIP;
+
+	struct litest_device *keyboard = litest_add_device(li, LITEST_KEYBOARD);
+
+	libinput_log_set_priority(li, LIBINPUT_LOG_PRIORITY_ERROR);
+	litest_drain_events(li);
+
+	/* Warm up the event pools and the plugin frame pool */
+	for (int i = 0; i < 3; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_keyboard_key(keyboard, KEY_A, true);
+		litest_keyboard_key(keyboard, KEY_A, false);
+		litest_dispatch(li);
+		litest_drain_events(li);
+	}
+
+	nallocations = 0;
+	count_allocations = true;
+	for (int i = 0; i < 10; i++) {
+		struct libinput_event *event;
+
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_keyboard_key(keyboard, KEY_A, true);
+		litest_keyboard_key(keyboard, KEY_A, false);
+		libinput_dispatch(li);
+		while ((event = libinput_get_event(li)))
+			libinput_event_destroy(event);
+	}
+	count_allocations = false;
+
+	litest_assert_int_eq(nallocations, 0U);
+
+	litest_delete_device(keyboard);
+#endif
+}
+END_TEST
+
+TEST_COLLECTION(allocations)
+{
+	/* clang-format off */
+	litest_add_for_device(dispatch_no_allocations, LITEST_MOUSE);
+	/* clang-format on */
+}
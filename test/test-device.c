@@ -1727,6 +1727,89 @@ START_TEST(abs_device_negative_resolution)
 }
 END_TEST
 
+static uint64_t
+histogram_bucket_sum(const struct libinput_latency_histogram *h)
+{
+	uint64_t sum = 0;
+
+	ARRAY_FOR_EACH(h->buckets, b)
+		sum += *b;
+
+	return sum;
+}
+
+START_TEST(device_latency_stats)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_latency_stats before, after;
+	struct libinput_event *event;
+	const uint64_t nframes = 5;
+	uint64_t nmotion = 0;
+	size_t size;
+
+	litest_assert(!libinput_get_latency_stats_enabled(li));
+	libinput_set_latency_stats_enabled(li, 1);
+	litest_assert(libinput_get_latency_stats_enabled(li));
+
+	litest_drain_events(li);
+	libinput_device_get_latency_stats(dev->libinput_device,
+					  &before,
+					  sizeof(before));
+
+	for (uint64_t i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		litest_assert_event_type(event, LIBINPUT_EVENT_POINTER_MOTION);
+		nmotion++;
+		libinput_event_destroy(event);
+	}
+	litest_assert_int_eq(nmotion, nframes);
+
+	size = libinput_device_get_latency_stats(dev->libinput_device,
+						 &after,
+						 sizeof(after));
+	litest_assert_int_eq(size, sizeof(after));
+
+	litest_assert_int_eq(after.dispatch.count - before.dispatch.count, nframes);
+	litest_assert_int_eq(after.processing.count - before.processing.count,
+			     nframes);
+	litest_assert_int_eq(after.dequeue.count - before.dequeue.count, nmotion);
+	litest_assert_int_eq(histogram_bucket_sum(&after.dispatch),
+			     after.dispatch.count);
+	litest_assert_int_eq(histogram_bucket_sum(&after.processing),
+			     after.processing.count);
+	litest_assert_int_eq(histogram_bucket_sum(&after.dequeue),
+			     after.dequeue.count);
+
+	/* A caller compiled against an older, smaller struct */
+	size = libinput_device_get_latency_stats(dev->libinput_device,
+						 &after,
+						 sizeof(after.dispatch));
+	litest_assert_int_eq(size, sizeof(after.dispatch));
+
+	/* Nothing is collected once disabled */
+	libinput_set_latency_stats_enabled(li, 0);
+	libinput_device_get_latency_stats(dev->libinput_device,
+					  &before,
+					  sizeof(before));
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+	litest_drain_events(li);
+	libinput_device_get_latency_stats(dev->libinput_device,
+					  &after,
+					  sizeof(after));
+	litest_assert_int_eq(after.dispatch.count, before.dispatch.count);
+	litest_assert_int_eq(after.processing.count, before.processing.count);
+	litest_assert_int_eq(after.dequeue.count, before.dequeue.count);
+}
+END_TEST
+
 TEST_COLLECTION(device)
 {
 	/* clang-format off */
@@ -1822,5 +1905,7 @@ TEST_COLLECTION(device)
 
 	litest_add(device_button_down_remove, LITEST_BUTTON, LITEST_ANY);
 
+	litest_add_for_device(device_latency_stats, LITEST_MOUSE);
+
 	/* clang-format off */
 }
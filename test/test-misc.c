@@ -27,6 +27,7 @@
 #include <fcntl.h>
 #include <libinput-util.h>
 #include <libinput.h>
+#include <poll.h>
 #include <stdarg.h>
 #include <unistd.h>
 
@@ -893,6 +894,648 @@ START_TEST(udev_absinfo_override)
 }
 END_TEST
 
+START_TEST(event_get_events_batch)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *events[4];
+	enum libinput_event_type types[4];
+	uint64_t times[4];
+	uint64_t last_time = 0;
+	size_t nevents, total = 0;
+
+	litest_drain_events(li);
+
+	for (int i = 0; i < 5; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+	litest_dispatch(li);
+
+	while ((nevents = libinput_get_events(li,
+					      events,
+					      types,
+					      times,
+					      ARRAY_LENGTH(events))) > 0) {
+		litest_assert_int_le(nevents, ARRAY_LENGTH(events));
+
+		for (size_t i = 0; i < nevents; i++) {
+			struct libinput_event_keyboard *kev;
+			enum libinput_key_state expected;
+
+			litest_assert_enum_eq(types[i], LIBINPUT_EVENT_KEYBOARD_KEY);
+			litest_assert_enum_eq(libinput_event_get_type(events[i]),
+					      types[i]);
+
+			kev = libinput_event_get_keyboard_event(events[i]);
+			litest_assert_int_eq(libinput_event_keyboard_get_time_usec(kev),
+					     times[i]);
+			litest_assert_int_ge(times[i], last_time);
+			last_time = times[i];
+
+			expected = (total + i) % 2 ? LIBINPUT_KEY_STATE_RELEASED
+						   : LIBINPUT_KEY_STATE_PRESSED;
+			litest_assert_enum_eq(libinput_event_keyboard_get_key_state(kev),
+					      expected);
+		}
+
+		total += nevents;
+		libinput_events_destroy(events, nevents);
+	}
+
+	litest_assert_int_eq(total, 10U);
+	litest_assert_empty_queue(li);
+
+	/* types and times are optional */
+	litest_keyboard_key(dev, KEY_A, true);
+	litest_keyboard_key(dev, KEY_A, false);
+	litest_dispatch(li);
+	nevents = libinput_get_events(li, events, NULL, NULL, ARRAY_LENGTH(events));
+	litest_assert_int_eq(nevents, 2U);
+	libinput_events_destroy(events, nevents);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+static void
+queue_overflow_generate_events(struct litest_device *dev, struct libinput *li)
+{
+	litest_drain_events(li);
+
+	litest_button_click_debounced(dev, li, BTN_LEFT, true);
+	for (int i = 0; i < 10; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_button_click_debounced(dev, li, BTN_LEFT, false);
+	litest_dispatch(li);
+}
+
+static void
+queue_overflow_assert_motion_events(struct libinput *li, int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct libinput_event *event = libinput_get_event(li);
+		litest_assert_event_type(event, LIBINPUT_EVENT_POINTER_MOTION);
+		libinput_event_destroy(event);
+	}
+}
+
+START_TEST(event_queue_overflow_drop_motion)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats stats;
+	int rc;
+
+	litest_drain_events(li);
+	rc = libinput_event_queue_configure(li,
+					    4,
+					    LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION);
+	litest_assert_neg_errno_success(rc);
+
+	queue_overflow_generate_events(dev, li);
+
+	/* The button events are never dropped, only the oldest motion
+	 * events are */
+	litest_assert_button_event(li, BTN_LEFT, LIBINPUT_BUTTON_STATE_PRESSED);
+	queue_overflow_assert_motion_events(li, 2);
+	litest_assert_button_event(li, BTN_LEFT, LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+
+	libinput_get_stats(li, &stats, sizeof(stats));
+	litest_assert_int_ge(stats.events_dropped, 7U);
+}
+END_TEST
+
+START_TEST(event_queue_overflow_coalesce_motion)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats stats;
+	int rc;
+
+	litest_drain_events(li);
+	rc = libinput_event_queue_configure(li,
+					    4,
+					    LIBINPUT_EVENT_QUEUE_OVERFLOW_COALESCE_MOTION);
+	litest_assert_neg_errno_success(rc);
+
+	queue_overflow_generate_events(dev, li);
+
+	/* Once full, motion events merge into the last queued motion
+	 * event, the button release grows the queue */
+	litest_assert_button_event(li, BTN_LEFT, LIBINPUT_BUTTON_STATE_PRESSED);
+	queue_overflow_assert_motion_events(li, 3);
+	litest_assert_button_event(li, BTN_LEFT, LIBINPUT_BUTTON_STATE_RELEASED);
+	litest_assert_empty_queue(li);
+
+	libinput_get_stats(li, &stats, sizeof(stats));
+	litest_assert_int_ge(stats.events_coalesced, 6U);
+}
+END_TEST
+
+START_TEST(event_queue_configure_invalid)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	int rc;
+
+	rc = libinput_event_queue_configure(li, 0, LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW);
+	litest_assert_int_eq(rc, -EINVAL);
+	rc = libinput_event_queue_configure(li,
+					    16,
+					    LIBINPUT_EVENT_QUEUE_OVERFLOW_DROP_OLDEST_MOTION +
+						    1);
+	litest_assert_int_eq(rc, -EINVAL);
+
+	litest_drain_events(li);
+	for (int i = 0; i < 4; i++) {
+		litest_keyboard_key(dev, KEY_A, true);
+		litest_keyboard_key(dev, KEY_A, false);
+	}
+	litest_dispatch(li);
+
+	/* can't shrink below the number of queued events */
+	rc = libinput_event_queue_configure(li, 4, LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW);
+	litest_assert_int_eq(rc, -EINVAL);
+	rc = libinput_event_queue_configure(li, 8, LIBINPUT_EVENT_QUEUE_OVERFLOW_GROW);
+	litest_assert_neg_errno_success(rc);
+
+	for (int i = 0; i < 4; i++) {
+		litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_PRESSED);
+		litest_assert_key_event(li, KEY_A, LIBINPUT_KEY_STATE_RELEASED);
+	}
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(event_pool_recycle)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats before, after;
+
+	litest_drain_events(li);
+	libinput_get_stats(li, &before, sizeof(before));
+
+	for (int i = 0; i < 10; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_dispatch(li);
+		litest_assert_only_typed_events(li, LIBINPUT_EVENT_POINTER_MOTION);
+	}
+
+	libinput_get_stats(li, &after, sizeof(after));
+
+	/* At most the first event needs a fresh allocation, all others
+	 * re-use the previously destroyed one */
+	litest_assert_int_le(after.event_pool_misses - before.event_pool_misses, 1U);
+	litest_assert_int_ge(after.event_pool_hits - before.event_pool_hits, 9U);
+}
+END_TEST
+
+START_TEST(stats_size)
+{
+	_litest_context_destroy_ struct libinput *li = litest_create_context();
+	struct {
+		struct libinput_stats stats;
+		uint64_t future_field;
+	} larger;
+	struct libinput_stats stats;
+	size_t nbytes;
+
+	memset(&larger, 0xab, sizeof(larger));
+	nbytes = libinput_get_stats(li, &larger.stats, sizeof(larger));
+	litest_assert_int_eq(nbytes, sizeof(struct libinput_stats));
+	litest_assert_int_eq(larger.future_field, 0U);
+
+	memset(&stats, 0xab, sizeof(stats));
+	nbytes = libinput_get_stats(li, &stats, sizeof(uint64_t));
+	litest_assert_int_eq(nbytes, sizeof(uint64_t));
+	litest_assert_int_eq(stats.event_pool_misses, 0xababababababababULL);
+}
+END_TEST
+
+START_TEST(stats_counters)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats before, after;
+	const uint64_t nframes = 5;
+
+	litest_drain_events(li);
+	libinput_get_stats(li, &before, sizeof(before));
+
+	/* All motion events are queued before we fetch any */
+	for (uint64_t i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_ge(after.events_queued_max, nframes);
+	litest_assert_int_ge(after.frames_processed - before.frames_processed,
+			     nframes);
+	litest_assert_int_eq(after.syn_dropped, 0U);
+	litest_drain_events(li);
+
+	/* The button press arms the debounce timer */
+	litest_button_click(dev, BTN_LEFT, true);
+	litest_dispatch(li);
+	libinput_get_stats(li, &before, sizeof(before));
+	litest_timeout_debounce(li);
+	litest_dispatch(li);
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_gt(after.timer_fires, before.timer_fires);
+
+	litest_button_click_debounced(dev, li, BTN_LEFT, false);
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(stats_timer_syscalls)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct litest_device *mouse2 = litest_add_device(li, LITEST_MOUSE);
+	struct libinput_stats before, after;
+
+	litest_drain_events(li);
+
+	/* Arms the first debounce timer */
+	litest_button_click(dev, BTN_LEFT, true);
+	litest_dispatch(li);
+
+	libinput_get_stats(li, &before, sizeof(before));
+
+	/* The second debounce timer expires after the first one, the
+	 * timerfd does not need to be reprogrammed */
+	litest_button_click(mouse2, BTN_LEFT, true);
+	litest_dispatch(li);
+
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_gt(after.timer_syscalls_skipped,
+			     before.timer_syscalls_skipped);
+
+	litest_timeout_debounce(li);
+	litest_button_click_debounced(dev, li, BTN_LEFT, false);
+	litest_button_click_debounced(mouse2, li, BTN_LEFT, false);
+	litest_drain_events(li);
+
+	litest_device_destroy(mouse2);
+}
+END_TEST
+
+START_TEST(stats_read_batching)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats before, after;
+	const int nframes = 10;
+
+	litest_drain_events(li);
+	libinput_get_stats(li, &before, sizeof(before));
+
+	/* All frames are pending in the kernel before we dispatch so
+	 * they're picked up with a single read() */
+	for (int i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_eq(after.read_frames - before.read_frames,
+			     (uint64_t)nframes);
+	litest_assert_int_eq(after.read_events - before.read_events,
+			     (uint64_t)nframes * 3);
+	/* With io_uring the kernel reads for us */
+	if (after.uring_completions == 0)
+		litest_assert_int_eq(after.read_syscalls - before.read_syscalls, 1U);
+	else
+		litest_assert_int_eq(after.read_syscalls, 0U);
+
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(stats_uring_reads)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct litest_device *kbd = litest_add_device(li, LITEST_KEYBOARD);
+	struct libinput_stats before, after;
+	const size_t nframes = 10;
+	size_t nmotion = 0, nkeys = 0;
+
+	litest_drain_events(li);
+	libinput_get_stats(li, &before, sizeof(before));
+
+	for (size_t i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_keyboard_key(kbd, KEY_A, true);
+	litest_keyboard_key(kbd, KEY_A, false);
+
+	/* io_uring completions may arrive in several batches */
+	while (nmotion < nframes || nkeys < 2) {
+		struct libinput_event *event;
+
+		litest_wait_for_event(li);
+		while ((event = libinput_get_event(li))) {
+			switch (libinput_event_get_type(event)) {
+			case LIBINPUT_EVENT_POINTER_MOTION:
+				nmotion++;
+				break;
+			case LIBINPUT_EVENT_KEYBOARD_KEY:
+				nkeys++;
+				break;
+			default:
+				break;
+			}
+			libinput_event_destroy(event);
+		}
+	}
+	litest_assert_int_eq(nmotion, nframes);
+	litest_assert_int_eq(nkeys, 2U);
+
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_eq(after.read_events - before.read_events,
+			     (uint64_t)nframes * 2 + 4);
+#ifndef HAVE_IO_URING
+	litest_assert_int_eq(after.uring_completions, 0U);
+#endif
+	/* Either the io_uring backend or the epoll fallback read the
+	 * devices, never both */
+	if (after.uring_completions > before.uring_completions)
+		litest_assert_int_eq(after.read_syscalls, before.read_syscalls);
+	else
+		litest_assert_int_gt(after.read_syscalls, before.read_syscalls);
+
+	litest_device_destroy(kbd);
+}
+END_TEST
+
+static size_t
+count_events_of_type(struct libinput *li, enum libinput_event_type type)
+{
+	struct libinput_event *event;
+	size_t count = 0;
+
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) == type)
+			count++;
+		libinput_event_destroy(event);
+	}
+
+	return count;
+}
+
+START_TEST(dispatch_budget)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_stats before, after;
+	const int nframes = 5;
+	size_t nmotion;
+	int rc;
+
+	rc = libinput_dispatch_configure(li, 0, 0x100);
+	litest_assert_int_eq(rc, -EINVAL);
+
+	/* REL_X, REL_Y, SYN_REPORT is exactly one frame */
+	rc = libinput_dispatch_configure(li, 3, LIBINPUT_DISPATCH_FLAG_NONE);
+	litest_assert_int_eq(rc, 0);
+
+	litest_drain_events(li);
+	libinput_get_stats(li, &before, sizeof(before));
+
+	for (int i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+
+	litest_dispatch(li);
+	nmotion = count_events_of_type(li, LIBINPUT_EVENT_POINTER_MOTION);
+	litest_assert_int_eq(nmotion, 1U);
+
+	libinput_get_stats(li, &after, sizeof(after));
+	litest_assert_int_gt(after.dispatch_budget_exhausted,
+			     before.dispatch_budget_exhausted);
+
+	/* The remaining frames are picked up by the next dispatches */
+	for (int i = 1; i < nframes; i++) {
+		litest_dispatch(li);
+		nmotion += count_events_of_type(li, LIBINPUT_EVENT_POINTER_MOTION);
+	}
+	litest_assert_int_eq(nmotion, (size_t)nframes);
+
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	libinput_dispatch_configure(li, 0, LIBINPUT_DISPATCH_FLAG_NONE);
+}
+END_TEST
+
+START_TEST(dispatch_budget_prioritize_keyboards)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct litest_device *keyboard = litest_add_device(li, LITEST_KEYBOARD);
+	struct libinput_event *event;
+	int rc;
+
+	rc = libinput_dispatch_configure(li,
+					 3,
+					 LIBINPUT_DISPATCH_FLAG_PRIORITIZE_KEYBOARDS);
+	litest_assert_int_eq(rc, 0);
+
+	litest_drain_events(li);
+
+	/* Mouse events are pending first, but the keyboard is processed
+	 * first */
+	for (int i = 0; i < 5; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_keyboard_key(keyboard, KEY_A, true);
+	litest_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_assert_notnull(event);
+	litest_assert_event_type(event, LIBINPUT_EVENT_KEYBOARD_KEY);
+	libinput_event_destroy(event);
+
+	libinput_dispatch_configure(li, 0, LIBINPUT_DISPATCH_FLAG_NONE);
+	litest_keyboard_key(keyboard, KEY_A, false);
+	litest_drain_events(li);
+
+	litest_device_destroy(keyboard);
+}
+END_TEST
+
+START_TEST(dispatch_budget_flood)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct litest_device *keyboard = litest_add_device(li, LITEST_KEYBOARD);
+	struct pollfd fds = { .fd = libinput_get_fd(li), .events = POLLIN };
+	const int nframes = 100;
+	size_t nmotion = 0, nkeys = 0;
+	int rc;
+
+	litest_drain_events(li);
+
+	/* One frame per device and dispatch, the mouse cannot be drained
+	 * before the keyboard events are read */
+	rc = libinput_dispatch_configure(li, 2, LIBINPUT_DISPATCH_FLAG_NONE);
+	litest_assert_int_eq(rc, 0);
+
+	for (int i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_keyboard_key(keyboard, KEY_A, true);
+	litest_keyboard_key(keyboard, KEY_A, false);
+
+	/* The mouse must not use up the read buffers of the keyboard */
+	for (int i = 0; i < nframes && nkeys < 2; i++) {
+		struct libinput_event *event;
+
+		poll(&fds, 1, 10);
+		litest_dispatch(li);
+		while ((event = libinput_get_event(li))) {
+			switch (libinput_event_get_type(event)) {
+			case LIBINPUT_EVENT_POINTER_MOTION:
+				nmotion++;
+				break;
+			case LIBINPUT_EVENT_KEYBOARD_KEY:
+				nkeys++;
+				break;
+			default:
+				break;
+			}
+			libinput_event_destroy(event);
+		}
+	}
+	litest_assert_int_eq(nkeys, 2U);
+	litest_assert_int_lt(nmotion, (size_t)nframes);
+
+	libinput_dispatch_configure(li, 0, LIBINPUT_DISPATCH_FLAG_NONE);
+	litest_drain_events(li);
+
+	litest_device_destroy(keyboard);
+}
+END_TEST
+
+START_TEST(reader_thread)
+{
+	_litest_context_destroy_ struct libinput *li = litest_create_context();
+	struct libinput_stats stats;
+	const size_t nframes = 10;
+	size_t nmotion = 0;
+	int rc;
+
+	rc = libinput_enable_reader_thread(li);
+	litest_assert_int_eq(rc, 0);
+	/* Enabling it twice is a noop */
+	rc = libinput_enable_reader_thread(li);
+	litest_assert_int_eq(rc, 0);
+
+	_destroy_(litest_device) *dev = litest_add_device(li, LITEST_MOUSE);
+	litest_drain_events(li);
+
+	for (size_t i = 0; i < nframes; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+
+	/* The reader thread may hand the frames over in several chunks */
+	while (nmotion < nframes) {
+		litest_wait_for_event(li);
+		nmotion += count_events_of_type(li, LIBINPUT_EVENT_POINTER_MOTION);
+	}
+	litest_assert_int_eq(nmotion, nframes);
+
+	libinput_get_stats(li, &stats, sizeof(stats));
+	litest_assert_int_eq(stats.read_frames, (uint64_t)nframes);
+	litest_assert_int_eq(stats.read_events, (uint64_t)nframes * 3);
+	litest_assert_int_ge(stats.read_syscalls, 1U);
+}
+END_TEST
+
+START_TEST(reader_thread_full_ring)
+{
+	_litest_context_destroy_ struct libinput *li = litest_create_context();
+	/* More events than fit into the reader thread's ring (4096
+	 * events), and 4096 isn't a multiple of the frame size so the
+	 * ring fills up in the middle of a frame */
+	const size_t nframes = 1400;
+	size_t nmotion = 0;
+	int rc;
+
+	rc = libinput_enable_reader_thread(li);
+	litest_assert_int_eq(rc, 0);
+
+	_destroy_(litest_device) *dev = litest_add_device(li, LITEST_MOUSE);
+	litest_drain_events(li);
+
+	litest_with_logcapture(li, capture) {
+		/* Don't dispatch, the reader thread fills the ring. Go
+		 * slow enough that the kernel buffer doesn't overflow
+		 * before the ring is full */
+		for (size_t i = 0; i < nframes; i++) {
+			litest_event(dev, EV_REL, REL_X, 1);
+			litest_event(dev, EV_REL, REL_Y, -1);
+			litest_event(dev, EV_SYN, SYN_REPORT, 0);
+			if (i % 4 == 0)
+				msleep(1);
+		}
+		msleep(20);
+
+		while (nmotion < nframes) {
+			struct libinput_event *event;
+
+			litest_wait_for_event(li);
+			while ((event = libinput_get_event(li))) {
+				struct libinput_event_pointer *p =
+					litest_is_motion_event(event);
+
+				/* A split frame would give us two events */
+				litest_assert_double_eq(
+					libinput_event_pointer_get_dx_unaccelerated(p),
+					1.0);
+				litest_assert_double_eq(
+					libinput_event_pointer_get_dy_unaccelerated(p),
+					-1.0);
+				nmotion++;
+				libinput_event_destroy(event);
+			}
+		}
+		litest_assert_int_eq(nmotion, nframes);
+		litest_assert_ptr_null(capture->bugs);
+	}
+}
+END_TEST
+
+START_TEST(reader_thread_after_devices)
+{
+	_litest_context_destroy_ struct libinput *li = litest_create_context();
+	_destroy_(litest_device) *dev = litest_add_device(li, LITEST_MOUSE);
+	int rc;
+
+	rc = libinput_enable_reader_thread(li);
+	litest_assert_int_eq(rc, -EBUSY);
+}
+END_TEST
+
 TEST_COLLECTION(misc)
 {
 	/* clang-format off */
@@ -916,6 +1559,23 @@ TEST_COLLECTION(misc)
 
 	litest_add_no_device(fd_no_event_leak);
 
+	litest_add_for_device(event_get_events_batch, LITEST_KEYBOARD);
+	litest_add_for_device(event_queue_overflow_drop_motion, LITEST_MOUSE);
+	litest_add_for_device(event_queue_overflow_coalesce_motion, LITEST_MOUSE);
+	litest_add_for_device(event_queue_configure_invalid, LITEST_KEYBOARD);
+	litest_add_for_device(event_pool_recycle, LITEST_MOUSE);
+	litest_add_deviceless(stats_size);
+	litest_add_for_device(stats_counters, LITEST_MOUSE);
+	litest_add_for_device(stats_timer_syscalls, LITEST_MOUSE);
+	litest_add_for_device(stats_read_batching, LITEST_MOUSE);
+	litest_add_for_device(stats_uring_reads, LITEST_MOUSE);
+	litest_add_for_device(dispatch_budget, LITEST_MOUSE);
+	litest_add_for_device(dispatch_budget_prioritize_keyboards, LITEST_MOUSE);
+	litest_add_for_device(dispatch_budget_flood, LITEST_MOUSE);
+	litest_add_no_device(reader_thread);
+	litest_add_no_device(reader_thread_after_devices);
+	litest_add_no_device(reader_thread_full_ring);
+
 	litest_add_for_device(udev_absinfo_override, LITEST_ABSINFO_OVERRIDE);
 	/* clang-format on */
 }
@@ -135,6 +135,51 @@ START_TEST(pointer_motion_relative)
 }
 END_TEST
 
+START_TEST(pointer_motion_relative_snapshot)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_pointer_snapshot snapshot;
+	struct {
+		struct libinput_event_pointer_snapshot snapshot;
+		uint64_t future_field;
+	} larger;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_X, 5);
+	litest_event(dev, EV_REL, REL_Y, -3);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *event = libinput_get_event(li);
+	struct libinput_event_pointer *ptrev = litest_is_motion_event(event);
+
+	size_t nbytes =
+		libinput_event_pointer_get_snapshot(ptrev, &snapshot, sizeof(snapshot));
+	litest_assert_int_eq(nbytes, sizeof(snapshot));
+	litest_assert_int_eq(snapshot.type, LIBINPUT_EVENT_POINTER_MOTION);
+	litest_assert_int_eq(snapshot.time_usec,
+			     libinput_event_pointer_get_time_usec(ptrev));
+	litest_assert_double_eq(snapshot.dx, libinput_event_pointer_get_dx(ptrev));
+	litest_assert_double_eq(snapshot.dy, libinput_event_pointer_get_dy(ptrev));
+	litest_assert_double_eq(snapshot.dx_unaccelerated,
+				libinput_event_pointer_get_dx_unaccelerated(ptrev));
+	litest_assert_double_eq(snapshot.dy_unaccelerated,
+				libinput_event_pointer_get_dy_unaccelerated(ptrev));
+	litest_assert_int_eq(snapshot.button, 0U);
+	litest_assert_int_eq(snapshot.axes, 0U);
+
+	/* A caller built against a newer version gets the rest zeroed */
+	memset(&larger, 0xab, sizeof(larger));
+	nbytes = libinput_event_pointer_get_snapshot(ptrev,
+						     &larger.snapshot,
+						     sizeof(larger));
+	litest_assert_int_eq(nbytes, sizeof(snapshot));
+	litest_assert_int_eq(larger.future_field, 0U);
+}
+END_TEST
+
 START_TEST(pointer_motion_relative_zero)
 {
 	struct litest_device *dev = litest_current_device();
@@ -382,6 +427,198 @@ START_TEST(pointer_motion_unaccel)
 }
 END_TEST
 
+START_TEST(pointer_motion_coalesced)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	struct libinput_stats stats;
+
+	litest_assert(!libinput_event_queue_get_coalescing(li));
+	libinput_event_queue_set_coalescing(li, 1);
+	litest_assert(libinput_event_queue_get_coalescing(li));
+
+	litest_drain_events(li);
+
+	for (int i = 0; i < 10; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_REL, REL_Y, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	litest_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+				10.0);
+	litest_assert_double_eq(libinput_event_pointer_get_dy_unaccelerated(ptrev),
+				-10.0);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	libinput_get_stats(li, &stats, sizeof(stats));
+	litest_assert_int_eq(stats.events_coalesced, 9U);
+
+	/* A button event in between stops coalescing */
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_button_click_debounced(dev, li, BTN_LEFT, true);
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+	libinput_event_destroy(event);
+	litest_assert_button_event(li, BTN_LEFT, LIBINPUT_BUTTON_STATE_PRESSED);
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	litest_button_click_debounced(dev, li, BTN_LEFT, false);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_drain_events(li);
+}
+END_TEST
+
+START_TEST(pointer_scroll_wheel_legacy_disabled)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+
+	litest_assert_int_eq(
+		libinput_set_event_type_enabled(li, LIBINPUT_EVENT_POINTER_AXIS, 0),
+		0);
+	litest_assert(!libinput_get_event_type_enabled(li, LIBINPUT_EVENT_POINTER_AXIS));
+	litest_assert(
+		libinput_get_event_type_enabled(li, LIBINPUT_EVENT_POINTER_SCROLL_WHEEL));
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_WHEEL_HI_RES, -120);
+	litest_event(dev, EV_REL, REL_WHEEL, -1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+
+	/* Only the high-resolution wheel event, no legacy event */
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_POINTER_SCROLL_WHEEL);
+
+	litest_assert_int_eq(
+		libinput_set_event_type_enabled(li, LIBINPUT_EVENT_POINTER_MOTION, 0),
+		0);
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	libinput_set_event_type_enabled(li, LIBINPUT_EVENT_POINTER_MOTION, 1);
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_POINTER_MOTION);
+
+	litest_assert_int_eq(
+		libinput_set_event_type_enabled(li, LIBINPUT_EVENT_DEVICE_REMOVED, 0),
+		-EINVAL);
+	litest_assert_int_eq(libinput_set_event_type_enabled(li, 123, 0), -EINVAL);
+}
+END_TEST
+
+START_TEST(pointer_scroll_wheel_coalesced)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	const enum libinput_pointer_axis axis = LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL;
+	bool have_lores = false, have_hires = false;
+
+	libinput_event_queue_set_coalescing(li, 1);
+	litest_drain_events(li);
+
+	for (int i = 0; i < 3; i++) {
+		litest_event(dev, EV_REL, REL_WHEEL_HI_RES, -120);
+		litest_event(dev, EV_REL, REL_WHEEL, -1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	/* One wheel event and one legacy axis event for all three clicks */
+	while ((event = libinput_get_event(li))) {
+		ptrev = litest_is_axis_event(event,
+					     LIBINPUT_EVENT_POINTER_SCROLL_WHEEL,
+					     axis,
+					     LIBINPUT_POINTER_AXIS_SOURCE_WHEEL);
+		if (litest_is_high_res_axis_event(event)) {
+			litest_assert(!have_hires);
+			have_hires = true;
+			litest_assert_double_eq(
+				libinput_event_pointer_get_scroll_value_v120(ptrev,
+									     axis),
+				360.0);
+		} else {
+			litest_assert(!have_lores);
+			have_lores = true;
+			litest_assert_double_eq(
+				libinput_event_pointer_get_axis_value_discrete(ptrev,
+									       axis),
+				3.0);
+		}
+		libinput_event_destroy(event);
+	}
+
+	litest_assert(have_lores);
+	litest_assert(have_hires);
+}
+END_TEST
+
+START_TEST(pointer_scroll_wheel_coalesced_partial_pair)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	const enum libinput_pointer_axis axis = LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL;
+	uint64_t last_time = 0;
+	double v120 = 0.0;
+
+	libinput_event_queue_set_coalescing(li, 1);
+	litest_drain_events(li);
+
+	/* A full click posts the wheel event and its legacy twin, the
+	 * partial clicks after it only post wheel events. These must not
+	 * be merged into the wheel event before the legacy event. */
+	litest_event(dev, EV_REL, REL_WHEEL_HI_RES, -120);
+	litest_event(dev, EV_REL, REL_WHEEL, -1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	for (int i = 0; i < 2; i++) {
+		msleep(2);
+		litest_event(dev, EV_REL, REL_WHEEL_HI_RES, -30);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		struct libinput_event_pointer *ptrev =
+			litest_is_axis_event(event,
+					     LIBINPUT_EVENT_POINTER_SCROLL_WHEEL,
+					     axis,
+					     LIBINPUT_POINTER_AXIS_SOURCE_WHEEL);
+		uint64_t time = libinput_event_pointer_get_time_usec(ptrev);
+
+		litest_assert_int_ge(time, last_time);
+		last_time = time;
+
+		if (litest_is_high_res_axis_event(event))
+			v120 += libinput_event_pointer_get_scroll_value_v120(ptrev,
+									     axis);
+		libinput_event_destroy(event);
+	}
+
+	litest_assert_double_eq(v120, 180.0);
+}
+END_TEST
+
 static void
 test_button_event(struct litest_device *dev, unsigned int button, int state)
 {
@@ -3900,6 +4137,7 @@ TEST_COLLECTION(pointer)
 {
 	/* clang-format off */
 	litest_add(pointer_motion_relative, LITEST_RELATIVE, LITEST_POINTINGSTICK);
+	litest_add_for_device(pointer_motion_relative_snapshot, LITEST_MOUSE);
 	litest_add_for_device(pointer_motion_relative_zero, LITEST_MOUSE);
 	litest_with_parameters(params,
 			       "direction", 'I', 8, litest_named_i32(N), litest_named_i32(NE),
@@ -3910,12 +4148,16 @@ TEST_COLLECTION(pointer)
 	}
 	litest_add(pointer_motion_absolute, LITEST_ABSOLUTE, LITEST_ANY);
 	litest_add(pointer_motion_unaccel, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_for_device(pointer_motion_coalesced, LITEST_MOUSE);
 	litest_add(pointer_button, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add_no_device(pointer_button_auto_release);
 	litest_add_no_device(pointer_seat_button_count);
 	litest_add_for_device(pointer_button_has_no_button, LITEST_KEYBOARD);
 	litest_add(pointer_recover_from_lost_button_count, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add(pointer_scroll_wheel, LITEST_WHEEL, LITEST_TABLET);
+	litest_add_for_device(pointer_scroll_wheel_coalesced, LITEST_MOUSE);
+	litest_add_for_device(pointer_scroll_wheel_coalesced_partial_pair, LITEST_MOUSE);
+	litest_add_for_device(pointer_scroll_wheel_legacy_disabled, LITEST_MOUSE);
 	litest_with_parameters(params, "axis", 'I', 2, litest_named_i32(REL_WHEEL_HI_RES, "vertical"),
 						       litest_named_i32(REL_HWHEEL_HI_RES, "horizontal")) {
 		litest_add_parametrized(pointer_scroll_wheel_hires, LITEST_WHEEL, LITEST_TABLET, params);
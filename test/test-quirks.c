@@ -23,7 +23,12 @@
 
 #include <config.h>
 
+#include <fcntl.h>
 #include <libinput.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util-stringbuf.h"
 
 #include "libinput-util.h"
 #include "litest.h"
@@ -1532,6 +1537,175 @@ START_TEST(quirks_ctx_ref)
 }
 END_TEST
 
+static bool quirks_loaded_from_cache;
+
+static void
+cache_log_handler(struct libinput *this_is_null,
+		  enum libinput_log_priority priority,
+		  const char *format,
+		  va_list args)
+{
+	if (strstr(format, "from cache"))
+		quirks_loaded_from_cache = true;
+}
+
+START_TEST(quirks_cache)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	const char quirks_file[] = "[Section name]\n"
+				   "MatchUdevType=mouse\n"
+				   "AttrSizeHint=10x20\n"
+				   "AttrLidSwitchReliability=reliable\n";
+	_destroy_(data_dir) *dd = data_dir_new(quirks_file);
+	char cache_file[PATH_MAX] = "/tmp/litest-quirk-cache-XXXXXX";
+	struct quirks_context *ctx;
+	struct quirks *q;
+	struct quirk_dimensions dim;
+	char *str;
+
+	int fd = mkstemp(cache_file);
+	litest_assert_errno_success(fd);
+	close(fd);
+
+	ctx = quirks_init_subsystem(dd->dirname,
+				    NULL,
+				    log_handler,
+				    NULL,
+				    QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert_neg_errno_success(quirks_context_write_cache(ctx, cache_file));
+	quirks_context_unref(ctx);
+
+	quirks_loaded_from_cache = false;
+	ctx = quirks_init_subsystem_with_cache(dd->dirname,
+					       NULL,
+					       cache_file,
+					       cache_log_handler,
+					       NULL,
+					       QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert(quirks_loaded_from_cache);
+
+	q = quirks_fetch_for_device(ctx, ud);
+	litest_assert_notnull(q);
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 10U);
+	litest_assert_int_eq(dim.y, 20U);
+	litest_assert(quirks_get_string(q, QUIRK_ATTR_LID_SWITCH_RELIABILITY, &str));
+	litest_assert_str_eq(str, "reliable");
+	quirks_unref(q);
+	quirks_context_unref(ctx);
+
+	/* Any change to the data files invalidates the cache */
+	struct timespec times[2] = {
+		{ .tv_nsec = UTIME_OMIT },
+		{ .tv_sec = 1 },
+	};
+	litest_assert_errno_success(utimensat(AT_FDCWD, dd->filename, times, 0));
+
+	quirks_loaded_from_cache = false;
+	ctx = quirks_init_subsystem_with_cache(dd->dirname,
+					       NULL,
+					       cache_file,
+					       cache_log_handler,
+					       NULL,
+					       QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+	litest_assert(!quirks_loaded_from_cache);
+
+	q = quirks_fetch_for_device(ctx, ud);
+	litest_assert_notnull(q);
+	litest_assert(quirks_has_quirk(q, QUIRK_ATTR_SIZE_HINT));
+	quirks_unref(q);
+	quirks_context_unref(ctx);
+
+	unlink(cache_file);
+}
+END_TEST
+
+START_TEST(quirks_match_benchmark)
+{
+	struct litest_device *dev = litest_current_device();
+	_unref_(udev_device) *ud =
+		libinput_device_get_udev_device(dev->libinput_device);
+	_destroy_(stringbuf) *b = stringbuf_new();
+	const int nsynthetic = 2000;
+	const int nfetches = 1000;
+	struct quirk_dimensions dim;
+	uint32_t threshold;
+	size_t nsections, ncandidates;
+	usec_t start, end;
+
+	/* Sections for other products of the device's vendor and
+	 * sections that match on name prefix and DMI but never match the
+	 * device or this host, followed by two that do */
+	for (int i = 0; i < nsynthetic; i++) {
+		_autofree_ char *section =
+			strdup_printf("[Synthetic product %d]\n"
+				      "MatchVendor=0x17EF\n"
+				      "MatchProduct=0x%04X\n"
+				      "AttrSizeHint=1x1\n"
+				      "[Synthetic name %d]\n"
+				      "MatchName=Synthetic Device %d*\n"
+				      "AttrSizeHint=2x2\n"
+				      "[Synthetic dmi %d]\n"
+				      "MatchDMIModalias=dmi:*svnSynthetic%d:*\n"
+				      "AttrSizeHint=3x3\n",
+				      i,
+				      0x2000 + i,
+				      i,
+				      i,
+				      i,
+				      i);
+		stringbuf_append_string(b, section);
+	}
+	stringbuf_append_string(b,
+				"[Mouse vendor]\n"
+				"MatchVendor=0x17EF\n"
+				"MatchProduct=0x6019\n"
+				"AttrSizeHint=40x50\n"
+				"[Mouse name]\n"
+				"MatchName=Lenovo*\n"
+				"MatchUdevType=mouse\n"
+				"AttrPalmSizeThreshold=5\n");
+
+	_destroy_(data_dir) *dd = data_dir_new(b->data);
+	_unref_(quirks_context) *ctx =
+		quirks_init_subsystem(dd->dirname,
+				      NULL,
+				      log_handler,
+				      NULL,
+				      QLOG_CUSTOM_LOG_PRIORITIES);
+	litest_assert_notnull(ctx);
+
+	now_in_us(&start);
+	for (int i = 0; i < nfetches; i++) {
+		_unref_(quirks) *q = quirks_fetch_for_device(ctx, ud);
+		litest_assert_notnull(q);
+	}
+	now_in_us(&end);
+
+	quirks_context_get_match_stats(ctx, &nsections, &ncandidates);
+	litest_assert_int_eq(nsections, (size_t)nsynthetic * 3 + 2);
+	litest_assert_int_ge(ncandidates, 2U);
+	litest_assert_int_le(ncandidates, 4U);
+
+	_unref_(quirks) *q = quirks_fetch_for_device(ctx, ud);
+	litest_assert(quirks_get_dimensions(q, QUIRK_ATTR_SIZE_HINT, &dim));
+	litest_assert_int_eq(dim.x, 40U);
+	litest_assert_int_eq(dim.y, 50U);
+	litest_assert(quirks_get_uint32(q, QUIRK_ATTR_PALM_SIZE_THRESHOLD, &threshold));
+	litest_assert_int_eq(threshold, 5U);
+
+	litest_checkpoint("%zu sections, %zu candidates: %.1fus per device",
+			  nsections,
+			  ncandidates,
+			  usec_as_uint64_t(usec_delta(end, start)) / (double)nfetches);
+}
+END_TEST
+
 TEST_COLLECTION(quirks)
 {
 	/* clang-format off */
@@ -1584,6 +1758,9 @@ TEST_COLLECTION(quirks)
 	litest_add_for_device(quirks_parse_bool_attr, LITEST_MOUSE);
 	litest_add_for_device(quirks_parse_integration_attr, LITEST_MOUSE);
 
+	litest_add_for_device(quirks_cache, LITEST_MOUSE);
+	litest_add_for_device(quirks_match_benchmark, LITEST_MOUSE);
+
 	litest_add_for_device(quirks_model_one, LITEST_MOUSE);
 	litest_add_for_device(quirks_model_zero, LITEST_MOUSE);
 	litest_with_parameters(params, "enable_model", 'b') {
@@ -1846,6 +1846,123 @@ START_TEST(motion)
 }
 END_TEST
 
+START_TEST(motion_snapshot)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_tablet_tool_snapshot snapshot;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 },
+	};
+
+	litest_tablet_proximity_in(dev, 5, 100, axes);
+	litest_drain_events(li);
+
+	litest_tablet_motion(dev, 20, 40, axes);
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *event = libinput_get_event(li);
+	struct libinput_event_tablet_tool *tev =
+		litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	size_t nbytes =
+		libinput_event_tablet_tool_get_snapshot(tev, &snapshot, sizeof(snapshot));
+	litest_assert_int_eq(nbytes, sizeof(snapshot));
+	litest_assert_int_eq(snapshot.type, LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+	litest_assert_int_eq(snapshot.time_usec,
+			     libinput_event_tablet_tool_get_time_usec(tev));
+	litest_assert_ptr_eq(snapshot.tool, libinput_event_tablet_tool_get_tool(tev));
+	litest_assert_int_eq(snapshot.proximity_state,
+			     libinput_event_tablet_tool_get_proximity_state(tev));
+	litest_assert_int_eq(snapshot.tip_state,
+			     libinput_event_tablet_tool_get_tip_state(tev));
+	litest_assert_double_eq(snapshot.x, libinput_event_tablet_tool_get_x(tev));
+	litest_assert_double_eq(snapshot.y, libinput_event_tablet_tool_get_y(tev));
+	litest_assert_double_eq(snapshot.dx, libinput_event_tablet_tool_get_dx(tev));
+	litest_assert_double_eq(snapshot.dy, libinput_event_tablet_tool_get_dy(tev));
+	litest_assert_double_eq(snapshot.distance,
+				libinput_event_tablet_tool_get_distance(tev));
+	litest_assert_double_eq(snapshot.pressure,
+				libinput_event_tablet_tool_get_pressure(tev));
+	litest_assert(snapshot.changed_axes & LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_X);
+	litest_assert(snapshot.changed_axes & LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_Y);
+	litest_assert_int_eq(
+		!!(snapshot.changed_axes & LIBINPUT_TABLET_TOOL_SNAPSHOT_AXIS_PRESSURE),
+		!!libinput_event_tablet_tool_pressure_has_changed(tev));
+	litest_assert_int_eq(snapshot.button, 0U);
+}
+END_TEST
+
+START_TEST(motion_batch)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_tablet_tool_snapshot snapshot;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 },
+	};
+	const int nmotions = 5;
+	unsigned int nsamples;
+	double last_x = -1;
+
+	litest_assert_int_eq(
+		libinput_get_event_type_enabled(li, LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH),
+		0);
+	libinput_set_event_type_enabled(li, LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH, 1);
+	libinput_set_event_type_enabled(li, LIBINPUT_EVENT_TABLET_TOOL_AXIS, 0);
+
+	litest_tablet_proximity_in(dev, 5, 100, axes);
+	litest_drain_events(li);
+
+	for (int i = 0; i < nmotions; i++) {
+		litest_tablet_motion(dev, 10 + i * 5, 40, axes);
+		litest_dispatch(li);
+	}
+
+	_destroy_(libinput_event) *event = libinput_get_event(li);
+	struct libinput_event_tablet_tool *tev =
+		litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH);
+	litest_assert_empty_queue(li);
+
+	nsamples = libinput_event_tablet_tool_get_sample_count(tev);
+	litest_assert_int_gt(nsamples, 1U);
+	litest_assert_int_le(nsamples, (unsigned int)nmotions);
+
+	for (unsigned int i = 0; i < nsamples; i++) {
+		size_t nbytes =
+			libinput_event_tablet_tool_get_sample_snapshot(tev,
+								       i,
+								       &snapshot,
+								       sizeof(snapshot));
+		litest_assert_int_eq(nbytes, sizeof(snapshot));
+		litest_assert_int_eq(snapshot.type,
+				     LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH);
+		litest_assert_ptr_eq(snapshot.tool,
+				     libinput_event_tablet_tool_get_tool(tev));
+		litest_assert_double_gt(snapshot.x, last_x);
+		last_x = snapshot.x;
+	}
+
+	/* The event itself reflects the most recent sample */
+	litest_assert_double_eq(last_x, libinput_event_tablet_tool_get_x(tev));
+	litest_assert_int_eq(snapshot.time_usec,
+			     libinput_event_tablet_tool_get_time_usec(tev));
+
+	litest_set_log_handler_bug(li);
+	litest_assert_int_eq(
+		libinput_event_tablet_tool_get_sample_snapshot(tev,
+							       nsamples,
+							       &snapshot,
+							       sizeof(snapshot)),
+		0U);
+	litest_restore_log_handler(li);
+}
+END_TEST
+
 START_TEST(left_handed)
 {
 #ifdef HAVE_LIBWACOM
@@ -2467,6 +2584,65 @@ START_TEST(tool_name)
 }
 END_TEST
 
+#ifdef HAVE_LIBWACOM
+static const char *
+tool_name_after_proximity_in(struct litest_device *dev)
+{
+	struct libinput *li = dev->libinput;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ ABS_MISC, 0x823 },
+		{ -1, -1 },
+	};
+	const char *name;
+
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *event = libinput_get_event(li);
+	auto tablet_event =
+		litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	auto tool = libinput_event_tablet_tool_get_tool(tablet_event);
+	name = libinput_tablet_tool_get_name(tool);
+
+	litest_tablet_proximity_out(dev);
+	litest_drain_events(li);
+
+	return name;
+}
+
+START_TEST(tool_name_shared_database)
+{
+	struct libinput *li_a = litest_create_context();
+	struct libinput *li_b = litest_create_context();
+	struct litest_device *dev_a =
+		litest_add_device(li_a, LITEST_WACOM_CINTIQ_PRO16_PEN);
+	struct litest_device *dev_b =
+		litest_add_device(li_b, LITEST_WACOM_CINTIQ_PRO16_PEN);
+	const char *name_a, *name_b;
+
+	name_a = tool_name_after_proximity_in(dev_a);
+	name_b = tool_name_after_proximity_in(dev_b);
+	litest_assert_str_eq(name_a, "Grip Pen");
+
+	/* Both contexts use the same database */
+	litest_assert_ptr_eq(name_a, name_b);
+
+	litest_device_destroy(dev_a);
+	litest_destroy_context(li_a);
+
+	/* Destroying the other context didn't destroy the database */
+	name_b = tool_name_after_proximity_in(dev_b);
+	litest_assert_str_eq(name_b, "Grip Pen");
+
+	litest_device_destroy(dev_b);
+	litest_destroy_context(li_b);
+}
+END_TEST
+#endif
+
 START_TEST(tool_no_name)
 {
 	struct litest_device *dev = litest_current_device();
@@ -2525,6 +2701,59 @@ START_TEST(serial_changes_tool)
 }
 END_TEST
 
+START_TEST(serial_tool_survives_eviction)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event_tablet_tool *tablet_event;
+	struct libinput_event *event;
+	struct libinput_tablet_tool *tool, *kept;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_KEY, BTN_TOOL_PEN, 1);
+	litest_event(dev, EV_MSC, MSC_SERIAL, 1000);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+
+	event = libinput_get_event(li);
+	tablet_event =
+		litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	kept = libinput_tablet_tool_ref(
+		libinput_event_tablet_tool_get_tool(tablet_event));
+	libinput_event_destroy(event);
+
+	litest_event(dev, EV_KEY, BTN_TOOL_PEN, 0);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_drain_events(li);
+
+	/* Enough short-lived tools to trigger eviction of unused ones */
+	for (int serial = 2000; serial < 2200; serial++) {
+		litest_event(dev, EV_KEY, BTN_TOOL_PEN, 1);
+		litest_event(dev, EV_MSC, MSC_SERIAL, serial);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_event(dev, EV_KEY, BTN_TOOL_PEN, 0);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		litest_drain_events(li);
+	}
+
+	litest_event(dev, EV_KEY, BTN_TOOL_PEN, 1);
+	litest_event(dev, EV_MSC, MSC_SERIAL, 1000);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_dispatch(li);
+
+	event = libinput_get_event(li);
+	tablet_event =
+		litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	tool = libinput_event_tablet_tool_get_tool(tablet_event);
+	litest_assert_ptr_eq(tool, kept);
+	litest_assert_int_eq(libinput_tablet_tool_get_serial(tool), (uint64_t)1000);
+	libinput_event_destroy(event);
+
+	libinput_tablet_tool_unref(kept);
+}
+END_TEST
+
 START_TEST(invalid_serials)
 {
 	struct litest_device *dev = litest_current_device();
@@ -8125,7 +8354,13 @@ TEST_COLLECTION(tablet)
 		litest_add_parametrized_for_device(tool_name, LITEST_WACOM_CINTIQ_PRO16_PEN, params);
 	}
 	litest_add_for_device(tool_no_name, LITEST_HUION_TABLET);
+#ifdef HAVE_LIBWACOM
+	litest_add_no_device(tool_name_shared_database);
+#endif
 	litest_add(serial_changes_tool, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
+	litest_add(serial_tool_survives_eviction,
+		   LITEST_TABLET | LITEST_TOOL_SERIAL,
+		   LITEST_ANY);
 	litest_add(invalid_serials, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
 	litest_add_no_device(tools_with_serials);
 	litest_add_no_device(tools_without_serials);
@@ -8135,6 +8370,8 @@ TEST_COLLECTION(tablet)
 	litest_add(button_seat_count, LITEST_TABLET, LITEST_ANY);
 	litest_add_no_device(button_up_on_delete);
 	litest_add(motion, LITEST_TABLET, LITEST_ANY);
+	litest_add(motion_snapshot, LITEST_TABLET, LITEST_ANY);
+	litest_add(motion_batch, LITEST_TABLET, LITEST_ANY);
 	litest_add(motion_event_state, LITEST_TABLET, LITEST_ANY);
 	litest_add_for_device(motion_outside_bounds, LITEST_WACOM_CINTIQ_24HD_PEN);
 	litest_add(tilt_available, LITEST_TABLET|LITEST_TILT, LITEST_ANY);
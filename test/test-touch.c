@@ -63,6 +63,78 @@ START_TEST(touch_frame_events)
 }
 END_TEST
 
+START_TEST(touch_aggregate_frame)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	enum libinput_event_type per_touch_types[] = {
+		LIBINPUT_EVENT_TOUCH_DOWN,   LIBINPUT_EVENT_TOUCH_UP,
+		LIBINPUT_EVENT_TOUCH_MOTION, LIBINPUT_EVENT_TOUCH_CANCEL,
+		LIBINPUT_EVENT_TOUCH_FRAME,
+	};
+
+	litest_assert(
+		!libinput_get_event_type_enabled(li, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME));
+	libinput_set_event_type_enabled(li, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME, 1);
+	ARRAY_FOR_EACH(per_touch_types, type)
+		libinput_set_event_type_enabled(li, *type, 0);
+
+	litest_drain_events(li);
+
+	litest_with_event_frame(dev) {
+		litest_touch_down(dev, 0, 10, 10);
+		litest_touch_down(dev, 1, 50, 50);
+	}
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *event = libinput_get_event(li);
+	litest_assert_event_type(event, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+	struct libinput_event_touch_aggregate *agg =
+		libinput_event_get_touch_aggregate_event(event);
+	litest_assert_ptr_eq(libinput_event_touch_aggregate_get_base_event(agg), event);
+	litest_assert_int_eq(libinput_event_touch_aggregate_get_touch_count(agg), 2U);
+	for (unsigned int i = 0; i < 2; i++) {
+		litest_assert_enum_eq(libinput_event_touch_aggregate_get_touch_type(agg, i),
+				      LIBINPUT_EVENT_TOUCH_DOWN);
+		litest_assert_int_eq(libinput_event_touch_aggregate_get_slot(agg, i),
+				     (int32_t)i);
+	}
+	litest_assert_double_lt(libinput_event_touch_aggregate_get_x_transformed(agg, 0, 100),
+				libinput_event_touch_aggregate_get_x_transformed(agg, 1, 100));
+	litest_assert_empty_queue(li);
+
+	litest_with_event_frame(dev) {
+		litest_touch_move(dev, 0, 20, 20);
+		litest_touch_move(dev, 1, 60, 60);
+	}
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *motion = libinput_get_event(li);
+	litest_assert_event_type(motion, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+	agg = libinput_event_get_touch_aggregate_event(motion);
+	litest_assert_int_eq(libinput_event_touch_aggregate_get_touch_count(agg), 2U);
+	litest_assert_enum_eq(libinput_event_touch_aggregate_get_touch_type(agg, 0),
+			      LIBINPUT_EVENT_TOUCH_MOTION);
+	litest_assert_empty_queue(li);
+
+	litest_touch_up(dev, 0);
+	litest_dispatch(li);
+
+	_destroy_(libinput_event) *up = libinput_get_event(li);
+	litest_assert_event_type(up, LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME);
+	agg = libinput_event_get_touch_aggregate_event(up);
+	litest_assert_int_eq(libinput_event_touch_aggregate_get_touch_count(agg), 1U);
+	litest_assert_enum_eq(libinput_event_touch_aggregate_get_touch_type(agg, 0),
+			      LIBINPUT_EVENT_TOUCH_UP);
+	litest_assert_int_eq(libinput_event_touch_aggregate_get_slot(agg, 0), 0);
+	litest_assert_double_eq(libinput_event_touch_aggregate_get_x(agg, 0), 0.0);
+	litest_assert_empty_queue(li);
+
+	litest_touch_up(dev, 1);
+	litest_drain_events(li);
+}
+END_TEST
+
 START_TEST(touch_downup_no_motion)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1332,6 +1404,7 @@ TEST_COLLECTION(touch)
 {
 	/* clang-format off */
 	litest_add(touch_frame_events, LITEST_TOUCH, LITEST_ANY);
+	litest_add_for_device(touch_aggregate_frame, LITEST_GENERIC_MULTITOUCH_SCREEN);
 	litest_add(touch_downup_no_motion, LITEST_TOUCH, LITEST_ANY);
 	litest_add(touch_downup_no_motion, LITEST_SINGLE_TOUCH, LITEST_TOUCHPAD);
 	litest_add_no_device(touch_abs_transform);
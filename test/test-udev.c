@@ -378,6 +378,149 @@ START_TEST(udev_suspend_resume)
 }
 END_TEST
 
+START_TEST(udev_fast_suspend_resume)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_event *event;
+	struct libinput_device *device = NULL;
+	const char *devnode = libevdev_uinput_get_devnode(dev->uinput);
+	const char *sysname = strrchr(devnode, '/') + 1;
+	int num_devices = 0;
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_set_fast_resume(li, 1), 0);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+
+	litest_assert_int_ge(litest_dispatch(li), 0);
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) == LIBINPUT_EVENT_DEVICE_ADDED) {
+			struct libinput_device *d = libinput_event_get_device(event);
+
+			num_devices++;
+			if (streq(libinput_device_get_sysname(d), sysname))
+				device = libinput_device_ref(d);
+		}
+		libinput_event_destroy(event);
+	}
+	litest_assert_notnull(device);
+
+	/* The configuration must survive the suspend */
+	litest_assert_int_eq(
+		libinput_device_config_tap_set_enabled(device,
+						       LIBINPUT_CONFIG_TAP_ENABLED),
+		LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	/* Devices are kept while suspended */
+	libinput_suspend(li);
+	litest_assert_int_ge(litest_dispatch(li), 0);
+	process_events_count_devices(li, &num_devices);
+	litest_assert_int_gt(num_devices, 0);
+
+	/* Only devices that changed may be removed and re-added, our
+	 * device must not be one of them */
+	litest_assert_int_eq(libinput_resume(li), 0);
+	litest_assert_int_ge(litest_dispatch(li), 0);
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) == LIBINPUT_EVENT_DEVICE_REMOVED)
+			litest_assert_ptr_ne(libinput_event_get_device(event), device);
+		libinput_event_destroy(event);
+	}
+
+	litest_assert_enum_eq(libinput_device_config_tap_get_enabled(device),
+			      LIBINPUT_CONFIG_TAP_ENABLED);
+
+	/* And it still sends events */
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_move_to(dev, 0, 50, 50, 70, 50, 10);
+	litest_touch_up(dev, 0);
+	litest_assert_int_ge(litest_dispatch(li), 0);
+
+	bool have_motion = false;
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) == LIBINPUT_EVENT_POINTER_MOTION &&
+		    libinput_event_get_device(event) == device)
+			have_motion = true;
+		libinput_event_destroy(event);
+	}
+	litest_assert(have_motion);
+
+	libinput_device_unref(device);
+}
+END_TEST
+
+START_TEST(udev_fast_resume_replaced_device)
+{
+	struct litest_device *dev = litest_create(LITEST_MOUSE, NULL, NULL, NULL, NULL);
+	struct libinput_event *event;
+	struct libinput_device *device = NULL;
+	const char *devnode = libevdev_uinput_get_devnode(dev->uinput);
+	_autofree_ char *sysname = safe_strdup(strrchr(devnode, '/') + 1);
+	bool removed = false, added = false;
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_set_fast_resume(li, 1), 0);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+
+	litest_assert_int_ge(litest_dispatch(li), 0);
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) == LIBINPUT_EVENT_DEVICE_ADDED) {
+			struct libinput_device *d = libinput_event_get_device(event);
+
+			if (streq(libinput_device_get_sysname(d), sysname))
+				device = libinput_device_ref(d);
+		}
+		libinput_event_destroy(event);
+	}
+	litest_assert_notnull(device);
+
+	libinput_suspend(li);
+	litest_drain_events(li);
+
+	/* Unplugged and a new device plugged in while suspended, the
+	 * kernel may even give it the same event node */
+	litest_device_destroy(dev);
+	dev = litest_create(LITEST_MOUSE, NULL, NULL, NULL, NULL);
+	devnode = libevdev_uinput_get_devnode(dev->uinput);
+
+	litest_assert_int_eq(libinput_resume(li), 0);
+	litest_assert_int_ge(litest_dispatch(li), 0);
+	while ((event = libinput_get_event(li))) {
+		struct libinput_device *d = libinput_event_get_device(event);
+
+		switch (libinput_event_get_type(event)) {
+		case LIBINPUT_EVENT_DEVICE_REMOVED:
+			if (d == device)
+				removed = true;
+			break;
+		case LIBINPUT_EVENT_DEVICE_ADDED:
+			litest_assert_ptr_ne(d, device);
+			if (streq(libinput_device_get_sysname(d),
+				  strrchr(devnode, '/') + 1))
+				added = true;
+			break;
+		default:
+			break;
+		}
+		libinput_event_destroy(event);
+	}
+	litest_assert(removed);
+	litest_assert(added);
+
+	libinput_device_unref(device);
+	litest_device_destroy(dev);
+}
+END_TEST
+
 START_TEST(udev_resume_before_seat)
 {
 	_unref_(udev) *udev = udev_new();
@@ -440,6 +583,76 @@ START_TEST(udev_device_sysname)
 }
 END_TEST
 
+START_TEST(udev_device_added_in_enumeration_order)
+{
+	enum litest_device_type types[] = {
+		LITEST_MOUSE,
+		LITEST_KEYBOARD,
+		LITEST_SYNAPTICS_CLICKPAD_X220,
+		LITEST_TRACKPOINT,
+		LITEST_GENERIC_SINGLETOUCH,
+		LITEST_MOUSE_ROCCAT,
+	};
+	struct litest_device *devices[ARRAY_LENGTH(types)];
+	const char *expected[ARRAY_LENGTH(types)];
+	struct udev_list_entry *entry;
+	struct libinput_event *ev;
+	size_t nexpected = 0, nadded = 0;
+
+	/* Enough devices for the probes to run on several threads */
+	for (size_t i = 0; i < ARRAY_LENGTH(types); i++)
+		devices[i] = litest_create(types[i], NULL, NULL, NULL, NULL);
+
+	_unref_(udev) *udev = udev_new();
+	litest_assert_notnull(udev);
+
+	/* The order we expect the devices in */
+	_unref_(udev_enumerate) *e = udev_enumerate_new(udev);
+	udev_enumerate_add_match_subsystem(e, "input");
+	udev_enumerate_scan_devices(e);
+	udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(e)) {
+		const char *syspath = udev_list_entry_get_name(entry);
+
+		for (size_t i = 0; i < ARRAY_LENGTH(devices); i++) {
+			const char *devnode =
+				libevdev_uinput_get_devnode(devices[i]->uinput);
+			const char *sysname = strrchr(devnode, '/') + 1;
+			const char *last = strrchr(syspath, '/');
+
+			if (last && streq(last + 1, sysname))
+				expected[nexpected++] = sysname;
+		}
+	}
+	litest_assert_int_eq(nexpected, ARRAY_LENGTH(devices));
+
+	_unref_(libinput) *li =
+		libinput_udev_create_context(&simple_interface, NULL, udev);
+	litest_assert_notnull(li);
+	litest_assert_int_eq(libinput_udev_assign_seat(li, "seat0"), 0);
+	litest_dispatch(li);
+
+	while ((ev = libinput_get_event(li))) {
+		if (libinput_event_get_type(ev) == LIBINPUT_EVENT_DEVICE_ADDED) {
+			struct libinput_device *device = libinput_event_get_device(ev);
+			const char *sysname = libinput_device_get_sysname(device);
+
+			for (size_t i = 0; i < nexpected; i++) {
+				if (!streq(expected[i], sysname))
+					continue;
+
+				litest_assert_int_eq(i, nadded);
+				nadded++;
+			}
+		}
+		libinput_event_destroy(ev);
+	}
+	litest_assert_int_eq(nadded, nexpected);
+
+	for (size_t i = 0; i < ARRAY_LENGTH(devices); i++)
+		litest_device_destroy(devices[i]);
+}
+END_TEST
+
 START_TEST(udev_seat_recycle)
 {
 	struct libinput_event *ev;
@@ -611,10 +824,13 @@ TEST_COLLECTION(udev)
 	litest_add_for_device(udev_double_suspend, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_double_resume, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_suspend_resume, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_for_device(udev_fast_suspend_resume, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_no_device(udev_fast_resume_replaced_device);
 	litest_add_for_device(udev_resume_before_seat, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_suspend_resume_before_seat, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_device_sysname, LITEST_SYNAPTICS_CLICKPAD_X220);
 	litest_add_for_device(udev_seat_recycle, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_no_device(udev_device_added_in_enumeration_order);
 
 	litest_add_no_device(udev_path_add_device);
 	litest_add_for_device(udev_path_remove_device, LITEST_SYNAPTICS_CLICKPAD_X220);
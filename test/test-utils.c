@@ -25,11 +25,13 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <valgrind/valgrind.h>
 
 #include "util-bits.h"
 #include "util-files.h"
+#include "util-heap.h"
 #include "util-input-event.h"
 #include "util-list.h"
 #include "util-macros.h"
@@ -39,6 +41,7 @@
 #include "util-prop-parsers.h"
 #include "util-range.h"
 #include "util-ratelimit.h"
+#include "util-ring.h"
 #include "util-stringbuf.h"
 #include "util-strings.h"
 #include "util-time.h"
@@ -2223,6 +2226,216 @@ START_TEST(strsanitize_test)
 }
 END_TEST
 
+START_TEST(heap_test_order)
+{
+	struct heap_test {
+		uint64_t key;
+		struct heap_node node;
+	} tests[] = {
+		{ .key = 40 }, { .key = 10 }, { .key = 30 }, { .key = 50 },
+		{ .key = 20 }, { .key = 70 }, { .key = 60 },
+	};
+	struct heap heap;
+	struct heap_node *node;
+	uint64_t last = 0;
+
+	heap_init(&heap);
+	litest_assert(heap_empty(&heap));
+	litest_assert_ptr_null(heap_first(&heap));
+
+	ARRAY_FOR_EACH(tests, t) {
+		heap_insert(&heap, &t->node, t->key);
+		litest_assert(heap_node_is_queued(&t->node));
+	}
+	litest_assert_int_eq(heap_length(&heap), ARRAY_LENGTH(tests));
+
+	while ((node = heap_first(&heap))) {
+		struct heap_test *t = container_of(node, struct heap_test, node);
+		litest_assert_int_gt(t->key, last);
+		last = t->key;
+		heap_remove(&heap, node);
+		litest_assert(!heap_node_is_queued(node));
+	}
+	litest_assert_int_eq(last, 70U);
+	litest_assert(heap_empty(&heap));
+
+	/* Identical keys are returned most recently inserted first */
+	ARRAY_FOR_EACH(tests, t) {
+		heap_insert(&heap, &t->node, 100);
+	}
+	for (int i = ARRAY_LENGTH(tests) - 1; i >= 0; i--) {
+		node = heap_first(&heap);
+		litest_assert_ptr_eq(node, &tests[i].node);
+		heap_remove(&heap, node);
+	}
+
+	heap_destroy(&heap);
+}
+END_TEST
+
+START_TEST(heap_test_update_remove)
+{
+	struct heap_test {
+		struct heap_node node;
+	} tests[8] = { 0 };
+	struct heap heap;
+
+	heap_init(&heap);
+
+	for (size_t i = 0; i < ARRAY_LENGTH(tests); i++)
+		heap_insert(&heap, &tests[i].node, (i + 1) * 10);
+
+	litest_assert_ptr_eq(heap_first(&heap), &tests[0].node);
+
+	/* Move the last node to the front and the first to the back */
+	heap_update(&heap, &tests[7].node, 5);
+	litest_assert_ptr_eq(heap_first(&heap), &tests[7].node);
+	heap_update(&heap, &tests[0].node, 100);
+	heap_update(&heap, &tests[7].node, 200);
+	litest_assert_ptr_eq(heap_first(&heap), &tests[1].node);
+
+	/* Remove a node from the middle */
+	heap_remove(&heap, &tests[3].node);
+	litest_assert_int_eq(heap_length(&heap), 7U);
+
+	size_t expected[] = { 1, 2, 4, 5, 6, 0, 7 };
+	ARRAY_FOR_EACH(expected, e) {
+		struct heap_node *node = heap_first(&heap);
+		litest_assert_ptr_eq(node, &tests[*e].node);
+		heap_remove(&heap, node);
+	}
+
+	litest_assert(heap_empty(&heap));
+	heap_destroy(&heap);
+}
+END_TEST
+
+START_TEST(heap_test_benchmark)
+{
+	/* Simulates a context with many armed timers where each
+	 * iteration re-arms one timer and expires the earliest one, the
+	 * typical pattern of tap/debounce/palm timers. Compares against
+	 * a linear scan for the earliest expiry. Keys are unique
+	 * (key % ntimers is the timer index) so both pick the same
+	 * timer. */
+	const size_t ntimers = 1024;
+	const size_t niterations = RUNNING_ON_VALGRIND ? 1000 : 100000;
+	struct heap_test {
+		uint64_t key;
+		struct heap_node node;
+	} *timers = zalloc(ntimers * sizeof(*timers));
+	struct heap heap;
+	uint64_t seed = 1;
+	usec_t start, end;
+	uint64_t heap_us, linear_us;
+	uint64_t checksum_heap = 0, checksum_linear = 0;
+
+#define next_random() (seed = seed * 6364136223846793005ULL + 1, seed >> 33)
+
+	heap_init(&heap);
+	for (size_t i = 0; i < ntimers; i++) {
+		timers[i].key = (1 + next_random() % 100000) * ntimers + i;
+		heap_insert(&heap, &timers[i].node, timers[i].key);
+	}
+
+	now_in_us(&start);
+	for (size_t i = 0; i < niterations; i++) {
+		struct heap_test *t = &timers[next_random() % ntimers];
+		t->key += (next_random() % 1000) * ntimers;
+		heap_update(&heap, &t->node, t->key);
+
+		struct heap_node *first = heap_first(&heap);
+		t = container_of(first, struct heap_test, node);
+		checksum_heap += t->key;
+		t->key += 100000 * ntimers;
+		heap_remove(&heap, first);
+		heap_insert(&heap, first, t->key);
+	}
+	now_in_us(&end);
+	heap_us = usec_as_uint64_t(usec_delta(end, start));
+
+	while (!heap_empty(&heap))
+		heap_remove(&heap, heap_first(&heap));
+	heap_destroy(&heap);
+
+	seed = 1;
+	for (size_t i = 0; i < ntimers; i++)
+		timers[i].key = (1 + next_random() % 100000) * ntimers + i;
+
+	now_in_us(&start);
+	for (size_t i = 0; i < niterations; i++) {
+		struct heap_test *t = &timers[next_random() % ntimers];
+		t->key += (next_random() % 1000) * ntimers;
+
+		struct heap_test *earliest = &timers[0];
+		for (size_t j = 1; j < ntimers; j++) {
+			if (timers[j].key < earliest->key)
+				earliest = &timers[j];
+		}
+		checksum_linear += earliest->key;
+		earliest->key += 100000 * ntimers;
+	}
+	now_in_us(&end);
+	linear_us = usec_as_uint64_t(usec_delta(end, start));
+
+#undef next_random
+
+	litest_assert_int_eq(checksum_heap, checksum_linear);
+
+	litest_checkpoint("%zu timers, %zu iterations: heap %" PRIu64
+			  "us, linear scan %" PRIu64 "us",
+			  ntimers,
+			  niterations,
+			  heap_us,
+			  linear_us);
+
+	free(timers);
+}
+END_TEST
+
+START_TEST(ring_test)
+{
+	struct ring ring;
+	int in[5] = { 1, 2, 3, 4, 5 };
+	int out[8] = { 0 };
+
+	ring_init(&ring, 6, sizeof(int));
+	litest_assert_int_eq(ring.size, 8U);
+	litest_assert_int_eq(ring_free(&ring), 8U);
+	litest_assert_int_eq(ring_count(&ring), 0U);
+
+	/* Pushed elements are invisible until published */
+	ring_push(&ring, in, 3);
+	litest_assert_int_eq(ring_free(&ring), 5U);
+	litest_assert_int_eq(ring_count(&ring), 0U);
+	litest_assert_int_eq(ring_pop(&ring, out, ARRAY_LENGTH(out)), 0U);
+
+	ring_publish(&ring);
+	litest_assert_int_eq(ring_count(&ring), 3U);
+	litest_assert_int_eq(ring_pop(&ring, out, 2), 2U);
+	litest_assert_int_eq(out[0], 1);
+	litest_assert_int_eq(out[1], 2);
+	litest_assert_int_eq(ring_free(&ring), 7U);
+
+	/* Wrap around the end of the buffer */
+	ring_push(&ring, in, 5);
+	ring_push(&ring, in, 2);
+	ring_publish(&ring);
+	litest_assert_int_eq(ring_free(&ring), 0U);
+	litest_assert_int_eq(ring_count(&ring), 8U);
+
+	litest_assert_int_eq(ring_pop(&ring, out, ARRAY_LENGTH(out)), 8U);
+	int expected[8] = { 3, 1, 2, 3, 4, 5, 1, 2 };
+	for (size_t i = 0; i < ARRAY_LENGTH(expected); i++)
+		litest_assert_int_eq(out[i], expected[i]);
+
+	litest_assert_int_eq(ring_free(&ring), 8U);
+	litest_assert_int_eq(ring_count(&ring), 0U);
+
+	ring_destroy(&ring);
+}
+END_TEST
+
 START_TEST(list_test_insert)
 {
 	struct list_test {
@@ -3226,6 +3439,87 @@ START_TEST(evdev_frames)
 }
 END_TEST
 
+START_TEST(evdev_frames_shared)
+{
+	struct evdev_event events[] = {
+		{
+			.usage = evdev_usage_from(EVDEV_REL_X),
+			.value = 1,
+		},
+		{
+			.usage = evdev_usage_from(EVDEV_REL_Y),
+			.value = 2,
+		},
+	};
+
+	/* Sharing only takes a reference */
+	{
+		_unref_(evdev_frame) *frame = evdev_frame_new(4);
+		struct evdev_frame *slot = NULL;
+
+		evdev_frame_append(frame, events, ARRAY_LENGTH(events));
+		evdev_frame_share(frame, &slot);
+		litest_assert_ptr_eq(slot, frame);
+
+		/* Taking it back while the owner still has a ref copies */
+		struct evdev_frame *taken = evdev_frame_take_shared(&slot);
+		litest_assert_ptr_ne(taken, frame);
+		litest_assert_ptr_eq(taken, slot);
+		litest_assert_int_eq(evdev_frame_get_count(taken), 3U);
+		evdev_frame_release_shared(&slot);
+		litest_assert_ptr_null(slot);
+	}
+
+	/* Modifying the original gives the slot the unmodified copy */
+	{
+		_unref_(evdev_frame) *frame = evdev_frame_new(4);
+		struct evdev_frame *slot = NULL;
+
+		evdev_frame_append(frame, events, 1);
+		evdev_frame_share(frame, &slot);
+		evdev_frame_append(frame, events + 1, 1);
+		litest_assert_ptr_ne(slot, frame);
+		litest_assert_int_eq(evdev_frame_get_count(slot), 2U);
+		litest_assert_int_eq(evdev_frame_get_count(frame), 3U);
+
+		evdev_frame_reset(frame);
+		litest_assert_int_eq(evdev_frame_get_count(slot), 2U);
+		evdev_frame_release_shared(&slot);
+	}
+
+	/* Once the owner drops its ref no copy is needed */
+	{
+		struct evdev_frame *frame = evdev_frame_new(4);
+		struct evdev_frame *slot = NULL;
+
+		evdev_frame_share(frame, &slot);
+		evdev_frame_unref(frame);
+		litest_assert_ptr_eq(evdev_frame_take_shared(&slot), frame);
+		evdev_frame_set_time(slot, usec_from_millis(10));
+		litest_assert_ptr_eq(slot, frame);
+		evdev_frame_release_shared(&slot);
+	}
+
+	/* Only one slot can share a frame, the second one gets a copy */
+	{
+		_unref_(evdev_frame) *frame = evdev_frame_new(4);
+		struct evdev_frame *slot1 = NULL;
+		struct evdev_frame *slot2 = NULL;
+
+		evdev_frame_share(frame, &slot1);
+		evdev_frame_share(frame, &slot2);
+		litest_assert_ptr_eq(slot1, frame);
+		litest_assert_ptr_ne(slot2, frame);
+		evdev_frame_release_shared(&slot2);
+		evdev_frame_release_shared(&slot1);
+
+		/* No longer shared, modifying doesn't touch the slots */
+		evdev_frame_append(frame, events, 1);
+		litest_assert_ptr_null(slot1);
+	}
+}
+END_TEST
+
 START_TEST(infmask_test)
 {
 	/* Test empty mask */
@@ -3435,6 +3729,10 @@ main(void)
 	ADD_TEST(list_test_foreach);
 	ADD_TEST(list_test_first_last);
 	ADD_TEST(list_test_chain);
+	ADD_TEST(heap_test_order);
+	ADD_TEST(heap_test_update_remove);
+	ADD_TEST(heap_test_benchmark);
+	ADD_TEST(ring_test);
 	ADD_TEST(strverscmp_test);
 	ADD_TEST(streq_test);
 	ADD_TEST(strneq_test);
@@ -3452,6 +3750,7 @@ main(void)
 	ADD_TEST(macros_expand);
 
 	ADD_TEST(evdev_frames);
+	ADD_TEST(evdev_frames_shared);
 
 	ADD_TEST(infmask_test);
 
@@ -23,6 +23,7 @@
 
 #include "config.h"
 
+#include <assert.h>
 #include <errno.h>
 #include <getopt.h>
 #include <inttypes.h>
@@ -50,9 +51,28 @@ static volatile sig_atomic_t stop = 0;
 static bool be_quiet = false;
 static bool compress_motion_events = false;
 static bool is_tty = false;
+static bool print_stats = false;
+static struct libinput_device **stats_devices;
+static size_t nstats_devices;
+static size_t stats_devices_size;
 
 #define printq(...) ({ if (!be_quiet)  printf(__VA_ARGS__); })
 
+static void
+stats_add_device(struct libinput_device *device)
+{
+	if (nstats_devices == stats_devices_size) {
+		size_t new_size = max(stats_devices_size * 2, 16U);
+		void *tmp = realloc(stats_devices, new_size * sizeof(*stats_devices));
+
+		assert(tmp);
+		stats_devices = tmp;
+		stats_devices_size = new_size;
+	}
+
+	stats_devices[nstats_devices++] = libinput_device_ref(device);
+}
+
 static int
 handle_and_print_events(struct libinput *li, const struct libinput_print_options *opts)
 {
@@ -108,6 +128,8 @@ handle_and_print_events(struct libinput *li, const struct libinput_print_options
 			case LIBINPUT_EVENT_DEVICE_ADDED:
 				tools_device_apply_config(libinput_event_get_device(ev),
 							  &options);
+				if (print_stats)
+					stats_add_device(device);
 				break;
 			case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY: {
 				struct libinput_event_tablet_tool *tev =
@@ -138,6 +160,65 @@ handle_and_print_events(struct libinput *li, const struct libinput_print_options
 	return rc;
 }
 
+/* Returns the upper bound in µs of the bucket that contains the given
+ * percentile of the samples */
+static uint64_t
+histogram_percentile(const struct libinput_latency_histogram *h, double percentile)
+{
+	uint64_t threshold = h->count * percentile / 100.0;
+	uint64_t total = 0;
+
+	for (size_t i = 0; i < ARRAY_LENGTH(h->buckets); i++) {
+		total += h->buckets[i];
+		if (total > threshold)
+			return i == 0 ? 0 : 1ULL << i;
+	}
+
+	return h->max_us;
+}
+
+static void
+print_latency_histogram(const char *name, const struct libinput_latency_histogram *h)
+{
+	if (h->count == 0) {
+		printf("  %-12s no samples\n", name);
+		return;
+	}
+
+	printf("  %-12s %8" PRIu64 " samples, mean %.2fms, p50 <%.2fms, "
+	       "p99 <%.2fms, max %.2fms\n",
+	       name,
+	       h->count,
+	       h->sum_us / (double)h->count / 1000.0,
+	       histogram_percentile(h, 50) / 1000.0,
+	       histogram_percentile(h, 99) / 1000.0,
+	       h->max_us / 1000.0);
+}
+
+static void
+print_latency_stats(void)
+{
+	for (size_t i = 0; i < nstats_devices; i++) {
+		struct libinput_device *device = stats_devices[i];
+		struct libinput_latency_stats stats;
+
+		libinput_device_get_latency_stats(device, &stats, sizeof(stats));
+
+		printf("%-7s %s\n",
+		       libinput_device_get_sysname(device),
+		       libinput_device_get_name(device));
+		print_latency_histogram("dispatch:", &stats.dispatch);
+		print_latency_histogram("processing:", &stats.processing);
+		print_latency_histogram("dequeue:", &stats.dequeue);
+
+		libinput_device_unref(device);
+	}
+	nstats_devices = 0;
+	free(stats_devices);
+	stats_devices = NULL;
+	stats_devices_size = 0;
+}
+
 static void
 sighandler(int signal, siginfo_t *siginfo, void *userdata)
 {
@@ -178,6 +259,9 @@ mainloop(struct libinput *li)
 	}
 
 	printf("\n");
+
+	if (print_stats)
+		print_latency_stats();
 }
 
 static void
@@ -215,6 +299,7 @@ main(int argc, char **argv)
 			OPT_SHOW_KEYCODES,
 			OPT_QUIET,
 			OPT_COMPRESS_MOTION_EVENTS,
+			OPT_STATS,
 		};
 		/* clang-format off */
 		static struct option opts[] = {
@@ -227,6 +312,7 @@ main(int argc, char **argv)
 			{ "verbose",                   no_argument,       0, OPT_VERBOSE },
 			{ "quiet",                     no_argument,       0, OPT_QUIET },
 			{ "compress-motion-events",    no_argument,       0, OPT_COMPRESS_MOTION_EVENTS },
+			{ "stats",                     no_argument,       0, OPT_STATS },
 			{ 0, 0, 0, 0},
 		};
 		/* clang-format on */
@@ -278,6 +364,9 @@ main(int argc, char **argv)
 			/* We compress by using ansi escape sequences */
 			compress_motion_events = is_tty;
 			break;
+		case OPT_STATS:
+			print_stats = true;
+			break;
 		default:
 			if (tools_parse_option(c, optarg, &options) != 0) {
 				usage(NULL);
@@ -329,6 +418,9 @@ main(int argc, char **argv)
 	if (!li)
 		return EXIT_FAILURE;
 
+	if (print_stats)
+		libinput_set_latency_stats_enabled(li, 1);
+
 	mainloop(li);
 
 	libinput_unref(li);
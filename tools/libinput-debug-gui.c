@@ -1832,6 +1832,7 @@ handle_event_libinput(GIOChannel *source, GIOCondition condition, gpointer data)
 			handle_event_touch(ev, w);
 			break;
 		case LIBINPUT_EVENT_TOUCH_FRAME:
+		case LIBINPUT_EVENT_TOUCH_AGGREGATE_FRAME:
 			break;
 		case LIBINPUT_EVENT_POINTER_AXIS:
 			/* ignore */
@@ -1871,6 +1872,8 @@ handle_event_libinput(GIOChannel *source, GIOCondition condition, gpointer data)
 		case LIBINPUT_EVENT_TABLET_TOOL_BUTTON:
 			handle_event_tablet(ev, w);
 			break;
+		case LIBINPUT_EVENT_TABLET_TOOL_AXIS_BATCH:
+			break;
 		case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
 		case LIBINPUT_EVENT_TABLET_PAD_RING:
 		case LIBINPUT_EVENT_TABLET_PAD_STRIP:
@@ -27,8 +27,10 @@
 #include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 
+#include "util-files.h"
 #include "util-mem.h"
 
 #include "builddir.h"
@@ -85,7 +87,10 @@ usage(void)
 	       "	Print the quirks for the given device\n"
 	       "\n"
 	       "  libinput quirks validate [--data-dir /path/to/quirks/dir]\n"
-	       "	Validate the database\n");
+	       "	Validate the database\n"
+	       "\n"
+	       "  libinput quirks compile [--data-dir /path/to/quirks/dir] [--output /path/to/cache]\n"
+	       "	Compile the database into a binary cache\n");
 }
 
 static void
@@ -98,7 +103,9 @@ int
 main(int argc, char **argv)
 {
 	const char *data_path = NULL, *override_file = NULL;
+	const char *cache_file = NULL;
 	bool validate = false;
+	bool compile = false;
 
 	while (1) {
 		int c;
@@ -106,11 +113,13 @@ main(int argc, char **argv)
 		enum {
 			OPT_VERBOSE,
 			OPT_DATADIR,
+			OPT_OUTPUT,
 		};
 		static struct option opts[] = {
 			{ "help", no_argument, 0, 'h' },
 			{ "verbose", no_argument, 0, OPT_VERBOSE },
 			{ "data-dir", required_argument, 0, OPT_DATADIR },
+			{ "output", required_argument, 0, OPT_OUTPUT },
 			{ 0, 0, 0, 0 }
 		};
 
@@ -132,6 +141,9 @@ main(int argc, char **argv)
 		case OPT_DATADIR:
 			data_path = optarg;
 			break;
+		case OPT_OUTPUT:
+			cache_file = optarg;
+			break;
 		default:
 			usage();
 			return EXIT_FAILURE;
@@ -156,6 +168,13 @@ main(int argc, char **argv)
 			return EXIT_FAILURE;
 		}
 		validate = true;
+	} else if (streq(argv[optind], "compile")) {
+		optind++;
+		if (optind < argc) {
+			usage();
+			return EXIT_FAILURE;
+		}
+		compile = true;
 	} else {
 		fprintf(stderr, "Unnkown action '%s'\n", argv[optind]);
 		return EXIT_FAILURE;
@@ -188,6 +207,24 @@ main(int argc, char **argv)
 	if (validate)
 		return EXIT_SUCCESS;
 
+	if (compile) {
+		if (!cache_file)
+			cache_file = LIBINPUT_QUIRKS_CACHE_FILE;
+
+		_autofree_ char *path = safe_strdup(cache_file);
+		int rc = mkdir_p(dirname(path));
+		if (rc == 0)
+			rc = quirks_context_write_cache(quirks, cache_file);
+		if (rc < 0) {
+			fprintf(stderr,
+				"Failed to write %s: %s\n",
+				cache_file,
+				strerror(-rc));
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
 	_unref_(udev) *udev = udev_new();
 	if (!udev)
 		return EXIT_FAILURE;
@@ -333,6 +333,10 @@ def test_debug_events_compress_motion_events(libinput_debug_events):
     libinput_debug_events.run_command_success(["--compress-motion-events"])
 
 
+def test_debug_events_stats(libinput_debug_events):
+    libinput_debug_events.run_command_success(["--stats"])
+
+
 def test_debug_events_grab(libinput_debug_events):
     libinput_debug_events.run_command_success(["--grab"])
 